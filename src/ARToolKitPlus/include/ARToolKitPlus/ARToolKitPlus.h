@@ -84,7 +84,8 @@ enum PIXEL_FORMAT {
 enum UNDIST_MODE {
 	UNDIST_NONE,
 	UNDIST_STD,
-	UNDIST_LUT
+	UNDIST_LUT,
+	UNDIST_LUT_SPARSE
 };
 
 
@@ -111,13 +112,16 @@ enum MARKER_MODE {
 	MARKER_TEMPLATE,
 	MARKER_ID_SIMPLE,
 	MARKER_ID_BCH,
+	MARKER_ID_DICTIONARY,
 	//MARKER_ID_BCH2		// upcomming, not implemented yet
 };
 
 enum POSE_ESTIMATOR {
 	POSE_ESTIMATOR_ORIGINAL,			// original "normal" pose estimator
 	POSE_ESTIMATOR_ORIGINAL_CONT,		// original "cont" pose estimator
-	POSE_ESTIMATOR_RPP					// new "Robust Planar Pose" estimator
+	POSE_ESTIMATOR_RPP,					// new "Robust Planar Pose" estimator
+	POSE_ESTIMATOR_LM,					// closed form initial pose (IPPE/EPnP) + Levenberg-Marquardt, also for non-planar multi-marker rigs
+	POSE_ESTIMATOR_AUTO					// per marker: "cont" if well-conditioned, "Robust Planar Pose" otherwise
 };
 
 
@@ -58,6 +58,18 @@ public:
 
 	virtual void observ2Ideal(ARFloat ox, ARFloat oy, ARFloat *ix, ARFloat *iy) = 0;
 	virtual void ideal2Observ(ARFloat ix, ARFloat iy, ARFloat *ox, ARFloat *oy) = 0;
+
+	/// Undistorts nNum points (nOx[i],nOy[i]) into (nIx[i],nIy[i])
+	/**
+	 *  Same result as observ2Ideal() for every point. Implementations override this
+	 *  with loops the compiler can vectorize. Input and output must not overlap.
+	 */
+	virtual void observ2IdealBatch(int nNum, const ARFloat* nOx, const ARFloat* nOy, ARFloat* nIx, ARFloat* nIy)
+	{
+		for(int i=0; i<nNum; i++)
+			observ2Ideal(nOx[i], nOy[i], nIx+i, nIy+i);
+	}
+
 	virtual bool loadFromFile(const char* filename) = 0;
 	virtual Camera* clone() = 0;
 	virtual bool changeFrameSize(const int frameWidth, const int frameHeight) = 0;
@@ -53,6 +53,7 @@ public:
 
 	virtual void observ2Ideal(ARFloat ox, ARFloat oy, ARFloat *ix, ARFloat *iy);
 	virtual void ideal2Observ(ARFloat ix, ARFloat iy, ARFloat *ox, ARFloat *oy);
+	virtual void observ2IdealBatch(int nNum, const ARFloat* nOx, const ARFloat* nOy, ARFloat* nIx, ARFloat* nIy);
 	virtual bool loadFromFile(const char* filename);
 	virtual Camera* clone();
 	virtual bool changeFrameSize(const int frameWidth, const int frameHeight);
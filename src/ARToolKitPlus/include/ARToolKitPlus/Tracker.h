@@ -101,6 +101,10 @@ public:
 	 *  can take quite a while. Consequently caching will speedup the start phase.
 	 *  If set to true and no cache file could be found a new one will be created.
 	 *  The cache file will get the same name as the camera file with the added extension '.LUT'
+	 *  It is memory mapped read-only, so all trackers on a machine share one copy.
+	 *  A cache written for another image size or other camera parameters (or in an
+	 *  older format) is rebuilt automatically (see ARUndistLUTHeader).
+	 *  Only used with UNDIST_LUT.
 	 */
 	virtual void setLoadUndistLUT(bool nSet) = 0;
 
@@ -122,12 +126,21 @@ public:
 	/// calculates the transformation matrix between camera and the given marker
 	virtual ARFloat arGetTransMat(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4]) = 0;
 
+	/// like arGetTransMat(), but picks the pose closer to prev_conv if the marker pose is ambiguous
 	virtual ARFloat arGetTransMatCont(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat center[2], ARFloat width, ARFloat conv[3][4]) = 0;
 
 	// RPP integration -- [t.pintaric]
 	virtual ARFloat rppMultiGetTransMat(ARMarkerInfo *marker_info, int marker_num, ARMultiMarkerInfoT *config) = 0;
 	virtual ARFloat rppGetTransMat(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4]) = 0;
 
+	/// RPP pose estimation with prev_conv as initial rotation, falls back to rppGetTransMat() if the result does not fit
+	virtual ARFloat rppGetTransMatCont(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat center[2], ARFloat width, ARFloat conv[3][4]) = 0;
+
+	// Levenberg-Marquardt pose refinement
+	virtual ARFloat lmMultiGetTransMat(ARMarkerInfo *marker_info, int marker_num, ARMultiMarkerInfoT *config) = 0;
+	virtual ARFloat lmGetTransMat(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4]) = 0;
+	virtual ARFloat lmGetTransMatCont(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat center[2], ARFloat width, ARFloat conv[3][4]) = 0;
+
 
 	/// loads a pattern from a file
 	virtual int arLoadPatt(char *filename) = 0;
@@ -136,18 +149,74 @@ public:
 	/// frees a pattern from memory
 	virtual int arFreePatt(int patno) = 0;
 
+	/// loads a compiled pattern bundle (see arSavePattBundle)
+	/**
+	 *  The bundle is memory mapped and its pre-normalized patterns are put
+	 *  into consecutive pattern slots without any parsing. Returns the id of
+	 *  the first pattern; the following patterns get consecutive ids in the
+	 *  order they were compiled. Returns -1 on failure.
+	 */
+	virtual int arLoadPattBundle(const char *filename) = 0;
+
+	/// writes all loaded patterns into a binary pattern bundle
+	/**
+	 *  This is the offline pattern compiler: load the pattern files with
+	 *  arLoadPatt() and write them out once. The bundle can only be loaded
+	 *  by trackers with the same pattern size and floating point precision.
+	 *  Returns the number of patterns written or -1 on failure.
+	 */
+	virtual int arSavePattBundle(const char *filename) = 0;
+
 	/// frees a multimarker config from memory
 	virtual int arMultiFreeConfig( ARMultiMarkerInfoT *config ) = 0;
 
 	/// reads a standard artoolkit multimarker config file
+	/**
+	 *  Compiled boards (see arMultiSaveConfigBinary) are detected and
+	 *  loaded via arMultiReadConfigBinary().
+	 */
 	virtual ARMultiMarkerInfoT *arMultiReadConfigFile(const char *filename) = 0;
 
+	/// loads a compiled multi-marker board (see arMultiSaveConfigBinary)
+	/**
+	 *  The board is memory mapped and its precomputed marker transformations,
+	 *  corner positions and id lookup table are copied without any parsing.
+	 *  Unlike text configs, a compiled board does not own the patterns its
+	 *  markers refer to. Returns NULL on failure.
+	 */
+	virtual ARMultiMarkerInfoT *arMultiReadConfigBinary(const char *filename) = 0;
+
+	/// writes a multi-marker config into a compiled binary board
+	/**
+	 *  This is the converter for existing config files: load them with
+	 *  arMultiReadConfigFile() and write them out once. The board can only
+	 *  be loaded by trackers with the same floating point precision.
+	 *  Returns the number of markers written or -1 on failure.
+	 */
+	virtual int arMultiSaveConfigBinary(ARMultiMarkerInfoT *config, const char *filename) = 0;
+
 	/// activates binary markers
 	/**
 	 *  markers are converted to pure black/white during loading
 	 */
 	virtual void activateBinaryMarker(int nThreshold) = 0;
 
+	/// activates PCA accelerated template matching
+	/**
+	 *  Instead of correlating the marker image with every template, the image is
+	 *  projected onto the eigen-basis of the pattern library (at most EVEC_MAX
+	 *  dimensions) and compared there. Only the best candidate is correlated in full.
+	 *  The eigen-basis is computed once after the pattern library changed or
+	 *  loaded from a pattern bundle. This pays off for larger libraries; with
+	 *  16x16 patterns it starts to beat brute force correlation at about 6-8 patterns
+	 *  and is roughly 8x faster at 48 patterns.
+	 *  Requires at least 4 loaded patterns, otherwise brute force matching is used.
+	 */
+	virtual void activatePCAMatching(bool nEnable) = 0;
+
+	/// Returns true if PCA accelerated template matching is activated
+	virtual bool isPCAMatchingActivated() const = 0;
+
 	/// activate the usage of id-based markers rather than template based markers
 	/**
 	 *  Template markers are the classic marker type used in ARToolKit.
@@ -155,10 +224,35 @@ public:
 	 *  Simple markers use 3-times redundancy to increase robustness, while
 	 *  BCH markers use an advanced CRC algorithm to detect and repair marker damages.
 	 *  See arBitFieldPattern.h for more information.
-	 *  In order to use id-based markers, the marker size has to be 6x6, 12x12 or 18x18.
+	 *  In order to use id-based markers, the marker size has to be a multiple of 6x6 (6x6, 12x12, 18x18, 24x24, ...).
+	 *  Dictionary markers use a marker dictionary (see generateMarkerDictionary() and
+	 *  loadMarkerDictionary()), in which case the marker size has to be a multiple
+	 *  of the dictionary's grid size.
 	 */
 	virtual void setMarkerMode(MARKER_MODE nMarkerMode) = 0;
 
+	/// Generates a dictionary for MARKER_ID_DICTIONARY mode
+	/**
+	 *  Creates up to nNumMarkers markers on an nGridSize x nGridSize grid (4 to 6)
+	 *  which differ in at least nMinDistance bits in all rotations. Up to
+	 *  (nMinDistance-1)/2 wrongly read bits get corrected. The same parameters always
+	 *  generate the same dictionary. Returns the number of markers generated.
+	 *  The inner grid should fill the whole area inside the black border, so
+	 *  setBorderWidth() has to match the printed markers. Grid sizes which do not
+	 *  divide the pattern size are rejected and generate no markers.
+	 */
+	virtual int generateMarkerDictionary(int nGridSize, int nNumMarkers, int nMinDistance) = 0;
+
+	/// Loads a dictionary for MARKER_ID_DICTIONARY mode from a file
+	/**
+	 *  See MarkerDictionary.h for the file format. Fails if the dictionary's
+	 *  grid size does not divide the pattern size.
+	 */
+	virtual bool loadMarkerDictionary(const char* nFileName) = 0;
+
+	/// Saves the current marker dictionary to a file
+	virtual bool saveMarkerDictionary(const char* nFileName) = 0;
+
 
 	/// activates the complensation of brightness falloff in the corners of the camera image
 	/**
@@ -183,6 +277,10 @@ public:
 	/**
 	 * Default value is UNDIST_STD which means that
 	 * artoolkit's standard undistortion method is used.
+	 * UNDIST_LUT looks up every pixel in a table of the full image size.
+	 * UNDIST_LUT_SPARSE interpolates bilinearly in a table with one entry every
+	 * AR_UNDIST_SPARSE_STEP pixels, which needs AR_UNDIST_SPARSE_STEP^2 times less
+	 * memory. Its error is checked when the table is built (see AR_UNDIST_SPARSE_MAX_ERROR).
 	 */
 	virtual void setUndistortionMode(UNDIST_MODE nMode) = 0;
 
@@ -190,6 +288,10 @@ public:
 	/**
 	* POSE_ESTIMATOR_ORIGINAL (default): arGetTransMat()
 	* POSE_ESTIMATOR_RPP: "Robust Pose Estimation from a Planar Target"
+	* POSE_ESTIMATOR_LM: closed form initial pose + Levenberg-Marquardt refinement
+	* POSE_ESTIMATOR_AUTO: picks ORIGINAL_CONT or RPP for every marker, depending on
+	*   its perspective distortion and previous fit error. markers smaller than
+	*   AR_POSE_AUTO_MIN_AREA pixels always use ORIGINAL_CONT
 	*/
 	virtual bool setPoseEstimator(POSE_ESTIMATOR nMethod) = 0;
 
@@ -203,6 +305,132 @@ public:
 	virtual void setBorderWidth(ARFloat nFraction) = 0;
 
 
+	/// Decodes marker candidates before fitting their edges
+	/**
+	 *  In cluttered scenes most candidates are rejected by the decoder. With
+	 *  decode-before-fit enabled the expensive edge line fitting (including
+	 *  undistortion of every contour point) only runs for candidates which
+	 *  decode with a confidence of at least AR_MIN_CONFIDENCE. Candidates that
+	 *  fail to decode are then dropped instead of being reported with id -1.
+	 */
+	virtual void activateDecodeBeforeFit(bool nEnable) = 0;
+
+
+	/// Rejects marker candidates whose border is not uniformly dark
+	/**
+	 *  Every quad found by the contour tracing is normally sampled and decoded.
+	 *  With the border check enabled a sparse ring of AR_BORDER_CHECK_SAMPLES
+	 *  points per side is sampled in the middle of the border band first and
+	 *  candidates with more than AR_BORDER_CHECK_MAX_BRIGHT samples brighter
+	 *  than the threshold are dropped before line fitting and decoding.
+	 *  This removes most false candidates on textured backgrounds.
+	 */
+	virtual void activateBorderCheck(bool nEnable) = 0;
+
+
+	/// Only reports markers whose ids are enabled in the id filter
+	/**
+	 *  The id filter is checked right after a candidate was decoded (the
+	 *  candidate is decoded before its edges are fitted while the filter
+	 *  is active). Markers with filtered ids skip line fitting and pose
+	 *  estimation and never show up in the results. Candidates that could
+	 *  not be decoded reliably are not affected. Works for all marker modes;
+	 *  for template markers the id is the pattern index.
+	 */
+	virtual void activateIdFilter(bool nEnable) = 0;
+
+	/// Enables or disables a single id in the id filter
+	/**
+	 *  Ids have to be smaller than AR_ID_FILTER_MAX. Returns false for invalid ids.
+	 */
+	virtual bool setIdFilterEntry(int nId, bool nAllowed) = 0;
+
+	/// Disables all ids in the id filter
+	virtual void clearIdFilter() = 0;
+
+
+	/// Reuses the ids of tracked markers instead of decoding them every frame
+	/**
+	 *  arDetectMarker() matches the marker candidates to the markers of the
+	 *  previous frame by area and position. With id reuse enabled, a candidate
+	 *  that continues exactly one confidently decoded marker (and no other
+	 *  candidate continues that marker) inherits its id, confidence and
+	 *  rotation without being sampled and decoded. Every nDecodeInterval
+	 *  frames a tracked marker gets decoded again.
+	 *  Not used by arDetectMarkerLite(), which does not keep a history.
+	 */
+	virtual void activateIdReuse(bool nEnable, int nDecodeInterval=10) = 0;
+
+
+	/// Warm starts the single marker pose estimators from the previous pose of each marker id
+	/**
+	 *  The tracker remembers the last pose of every marker id. If a marker was seen within
+	 *  the last AR_POSE_HISTORY_MAX_AGE frames, its previous rotation is used as initial
+	 *  estimate (the initial rotation of RPP for POSE_ESTIMATOR_RPP). If the warm started
+	 *  pose does not fit well, the marker is solved again from scratch and the better pose
+	 *  is kept. POSE_ESTIMATOR_ORIGINAL uses arGetTransMatCont(), which picks the closed form
+	 *  solution closer to the previous rotation and only iterates from the previous rotation
+	 *  if there is no closed form solution.
+	 *  POSE_ESTIMATOR_ORIGINAL_CONT and POSE_ESTIMATOR_AUTO always use the pose history.
+	 */
+	virtual void activatePoseHistory(bool nEnable) = 0;
+
+
+	/// Smoothes the marker poses over time and allows to predict them
+	/**
+	 *  Every pose found by executeSingleMarkerPoseEstimator() (and so by calc())
+	 *  or executeSingleMarkerPoseEstimatorBatch() is fed into a constant velocity
+	 *  alpha-beta filter per marker id (see PoseFilter), stamped with the current
+	 *  frame time (see setFrameTime()). getFilteredMarkerPose() returns the
+	 *  filtered pose extrapolated to any time, e.g. the time the rendered frame
+	 *  will be displayed. The poses returned by calc() stay unfiltered.
+	 *  nAlpha and nBeta are the gains for pose and velocity (see PoseFilter::setGains()).
+	 *  Disabling the filter forgets all markers.
+	 */
+	virtual void activatePoseFilter(bool nEnable, ARFloat nAlpha=AR_POSE_FILTER_ALPHA, ARFloat nBeta=AR_POSE_FILTER_BETA) = 0;
+
+
+	/// Sets the capture time (seconds) of the image passed to the next calc()
+	/**
+	 *  If no time is set for an image, the frame time advances by
+	 *  1/AR_POSE_FILTER_DEFAULT_FPS seconds.
+	 */
+	virtual void setFrameTime(double nTime) = 0;
+
+
+	/// Returns the capture time of the image processed last
+	virtual double getFrameTime() const = 0;
+
+
+	/// Returns the filtered pose of marker nId extrapolated to time nTime (see activatePoseFilter())
+	/**
+	 *  Returns false if the pose filter is disabled or the marker was not seen
+	 *  within AR_POSE_FILTER_MAX_GAP seconds before nTime.
+	 */
+	virtual bool getFilteredMarkerPose(int nId, double nTime, ARFloat nTrans[3][4]) = 0;
+
+
+	/// Returns the image space bounding box (minX, minY, maxX, maxY) marker nId is expected at for time nTime
+	/**
+	 *  The box is conservative: it contains the projection of the marker's bounding
+	 *  circle plus a margin (see AR_PREDICTED_SEARCH_MARGIN) and is clipped to the image.
+	 *  Returns false if no filtered pose is available (see getFilteredMarkerPose()).
+	 */
+	virtual bool getPredictedMarkerBox(int nId, double nTime, int nBox[4]) = 0;
+
+
+	/// Restricts marker detection to where tracked markers are predicted to be
+	/**
+	 *  Requires the pose filter (see activatePoseFilter()). Before an image is
+	 *  processed, the boxes of all targets seen in the previous image are predicted
+	 *  for the new frame time and only their bounding rectangle gets labeled.
+	 *  The full image is searched if nothing is tracked, if nothing was found in the
+	 *  predicted region and every AR_PREDICTED_SEARCH_FULL_INTERVAL frames, so that
+	 *  new markers get picked up.
+	 */
+	virtual void activatePredictedSearch(bool nEnable) = 0;
+
+
 	/// Sets the threshold value that is used for black/white conversion
 	virtual void setThreshold(int nValue) = 0;
 
@@ -292,6 +520,18 @@ public:
 	/// Calls the pose estimator set with setPoseEstimator() for single marker tracking
 	virtual ARFloat executeSingleMarkerPoseEstimator(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4]) = 0;
 
+	/// Calls the pose estimator set with setPoseEstimator() for all markers of an ARMarkerInfo array
+	/**
+	 *  Writes the transformation of marker_info[i] into conv[i] and its error into err[i]
+	 *  (a negative error means no pose could be found). All markers share the same center
+	 *  and width. Warm starts use the pose history (see activatePoseHistory()), which
+	 *  is updated once all markers are done.
+	 *  If ARToolKitPlus is compiled with OpenMP the markers are distributed over all cores
+	 *  as soon as there are at least AR_BATCH_POSE_MIN_PARALLEL of them.
+	 *  Returns the number of markers for which a pose was found.
+	 */
+	virtual int executeSingleMarkerPoseEstimatorBatch(ARMarkerInfo *marker_info, int marker_num, ARFloat center[2], ARFloat width, ARFloat conv[][3][4], ARFloat err[]) = 0;
+
 	/// Calls the pose estimator set with setPoseEstimator() for multi marker tracking
 	virtual ARFloat executeMultiMarkerPoseEstimator(ARMarkerInfo *marker_info, int marker_num, ARMultiMarkerInfoT *config) = 0;
 };
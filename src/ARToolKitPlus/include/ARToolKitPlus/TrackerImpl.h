@@ -50,6 +50,10 @@
 #include <ARToolKitPlus/Camera.h>
 #include <ARToolKitPlus/CameraFactory.h>
 #include <ARToolKitPlus/extra/BCH.h>
+#include <ARToolKitPlus/extra/MarkerDictionary.h>
+#include <ARToolKitPlus/extra/PoseFilter.h>
+#include <ARToolKitPlus/extra/MappedFile.h>
+#include <ARToolKitPlus/arUndistLUT.h>
 
 
 #if defined(_MSC_VER)
@@ -101,7 +105,7 @@ public:
 
 		MAX_LOAD_PATTERNS = __MAX_LOAD_PATTERNS,
 		MAX_IMAGE_PATTERNS = __MAX_IMAGE_PATTERNS,
-		WORK_SIZE = 1024*MAX_IMAGE_PATTERNS,
+		WORK_SIZE = AR_LABEL_WORK_SIZE*MAX_IMAGE_PATTERNS,
 
 #ifdef SMALL_LUM8_TABLE
 		LUM_TABLE_SIZE = (0xffff >> 6) + 1,
@@ -156,6 +160,12 @@ public:
 	// RPP integration -- [t.pintaric]
 	virtual ARFloat rppMultiGetTransMat(ARMarkerInfo *marker_info, int marker_num, ARMultiMarkerInfoT *config);
 	virtual ARFloat rppGetTransMat(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4]);
+	virtual ARFloat rppGetTransMatCont(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat center[2], ARFloat width, ARFloat conv[3][4]);
+
+	// Levenberg-Marquardt pose refinement
+	virtual ARFloat lmMultiGetTransMat(ARMarkerInfo *marker_info, int marker_num, ARMultiMarkerInfoT *config);
+	virtual ARFloat lmGetTransMat(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4]);
+	virtual ARFloat lmGetTransMatCont(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat center[2], ARFloat width, ARFloat conv[3][4]);
 
 	/// loads a pattern from a file
 	virtual int arLoadPatt(char *filename);
@@ -163,12 +173,36 @@ public:
 	/// frees a pattern from memory
 	virtual int arFreePatt(int patno);
 
+	/// loads a compiled pattern bundle
+	virtual int arLoadPattBundle(const char *filename);
+
+	/// writes all loaded patterns into a pattern bundle
+	virtual int arSavePattBundle(const char *filename);
+
 	virtual int arMultiFreeConfig( ARMultiMarkerInfoT *config );
 
 	virtual ARMultiMarkerInfoT *arMultiReadConfigFile(const char *filename);
 
+	/// loads a compiled multi-marker board
+	virtual ARMultiMarkerInfoT *arMultiReadConfigBinary(const char *filename);
+
+	/// writes a multi-marker config as compiled board
+	virtual int arMultiSaveConfigBinary(ARMultiMarkerInfoT *config, const char *filename);
+
 	virtual void activateBinaryMarker(int nThreshold)  {  binaryMarkerThreshold = nThreshold;  }
 
+	/// Turns PCA accelerated template matching on/off
+	/**
+	 *  The eigen-basis of the pattern library is built on the first match after
+	 *  the library was changed (or taken from a pattern bundle) and reused after that.
+	 *  Matching then costs O(EVEC_MAX) per template instead of O(PATTERN_WIDTH*PATTERN_HEIGHT*3).
+	 *  Requires at least 4 loaded patterns and color template matching.
+	 */
+	virtual void activatePCAMatching(bool nEnable)  {  arMatchingPCAMode = nEnable ? AR_MATCHING_WITH_PCA : AR_MATCHING_WITHOUT_PCA;  }
+
+	/// Returns true if PCA accelerated template matching is activated
+	virtual bool isPCAMatchingActivated() const  {  return arMatchingPCAMode==AR_MATCHING_WITH_PCA;  }
+
 	/// Activate the usage of id-based markers rather than template based markers
 	/**
 	 *  id-based markers directly encode the marker id in the image.
@@ -176,6 +210,15 @@ public:
 	 */
 	virtual void setMarkerMode(MARKER_MODE nMarkerMode);
 
+	/// Generates a dictionary for MARKER_ID_DICTIONARY mode
+	virtual int generateMarkerDictionary(int nGridSize, int nNumMarkers, int nMinDistance);
+
+	/// Loads a dictionary for MARKER_ID_DICTIONARY mode from a file
+	virtual bool loadMarkerDictionary(const char* nFileName);
+
+	/// Saves the current marker dictionary to a file
+	virtual bool saveMarkerDictionary(const char* nFileName);
+
 
 	/// activates the complensation of brightness falloff in the corners of the camera image
 	/**
@@ -210,6 +253,10 @@ public:
 	/**
 	 * Default value is UNDIST_STD which means that
 	 * artoolkit's standard undistortion method is used.
+	 * UNDIST_LUT looks up every pixel in a table of the full image size.
+	 * UNDIST_LUT_SPARSE interpolates bilinearly in a table with one entry every
+	 * AR_UNDIST_SPARSE_STEP pixels, which needs AR_UNDIST_SPARSE_STEP^2 times less
+	 * memory. Its error is checked when the table is built (see AR_UNDIST_SPARSE_MAX_ERROR).
 	 */
 	virtual void setUndistortionMode(UNDIST_MODE nMode);
 
@@ -217,6 +264,9 @@ public:
 	/**
 	* POSE_ESTIMATOR_ORIGINAL (default): arGetTransMat()
 	* POSE_ESTIMATOR_RPP: "Robust Pose Estimation from a Planar Target"
+	* POSE_ESTIMATOR_LM: closed form initial pose + Levenberg-Marquardt refinement
+	* POSE_ESTIMATOR_AUTO: picks ORIGINAL_CONT or RPP for every marker, depending on
+	*   its image area, perspective distortion and previous fit error
 	*/
 	virtual bool setPoseEstimator(POSE_ESTIMATOR nMethod);
 
@@ -230,6 +280,63 @@ public:
 	virtual void setBorderWidth(ARFloat nFraction)  {  relBorderWidth = nFraction;  }
 
 
+	/// Decodes marker candidates before fitting their edges
+	/**
+	 *  By default every candidate gets its undistorted edge lines fitted (arGetLine)
+	 *  before it is decoded. With decode-before-fit the candidate is sampled and
+	 *  decoded first and the line fit only runs if the confidence reaches
+	 *  AR_MIN_CONFIDENCE (or if the candidate continues a tracked marker).
+	 *  Candidates that fail to decode are dropped instead of being reported with id -1.
+	 */
+	virtual void activateDecodeBeforeFit(bool nEnable)  {  decodeBeforeFit = nEnable;  }
+
+
+	/// Verifies the black marker border before a candidate is processed further
+	/**
+	 *  Samples a sparse ring of points in the middle of the border band
+	 *  (see setBorderWidth()) and rejects candidates with too many samples
+	 *  brighter than the current threshold. Runs before line fitting and decoding.
+	 */
+	virtual void activateBorderCheck(bool nEnable)  {  borderCheck = nEnable;  }
+
+
+	/// Only reports markers whose ids are enabled in the id filter
+	virtual void activateIdFilter(bool nEnable)  {  idFilterEnabled = nEnable;  }
+
+	/// Enables or disables a single id in the id filter
+	virtual bool setIdFilterEntry(int nId, bool nAllowed);
+
+	/// Disables all ids in the id filter
+	virtual void clearIdFilter();
+
+
+	/// Reuses the ids of tracked markers instead of decoding them every frame
+	virtual void activateIdReuse(bool nEnable, int nDecodeInterval=10)  {  idReuse = nEnable;  idReuseInterval = nDecodeInterval;  }
+
+
+	/// Warm starts the single marker pose estimators from the previous pose of each marker id
+	virtual void activatePoseHistory(bool nEnable)  {  poseHistoryEnabled = nEnable;  }
+
+
+	/// Smoothes the marker poses over time and allows to predict them
+	virtual void activatePoseFilter(bool nEnable, ARFloat nAlpha=AR_POSE_FILTER_ALPHA, ARFloat nBeta=AR_POSE_FILTER_BETA);
+
+	/// Sets the capture time (seconds) of the image passed to the next calc()
+	virtual void setFrameTime(double nTime)  {  nextFrameTime = nTime;  nextFrameTimeSet = true;  }
+
+	/// Returns the capture time of the image processed last
+	virtual double getFrameTime() const  {  return frameTime;  }
+
+	/// Returns the filtered pose of marker nId extrapolated to time nTime
+	virtual bool getFilteredMarkerPose(int nId, double nTime, ARFloat nTrans[3][4])  {  return poseFilterEnabled && poseFilter.getPose(nId, nTime, nTrans);  }
+
+	/// Returns the image space bounding box marker nId is expected at for time nTime
+	virtual bool getPredictedMarkerBox(int nId, double nTime, int nBox[4])  {  return poseFilterEnabled && getPredictedBox(poseFilter, nId, nTime, nBox);  }
+
+	/// Restricts marker detection to where tracked markers are predicted to be
+	virtual void activatePredictedSearch(bool nEnable)  {  predictedSearch = nEnable;  predictedSearchCountdown = 0;  }
+
+
 	/// Sets the threshold value that is used for black/white conversion
 	virtual void setThreshold(int nValue)  {  thresh = nValue;  }
 
@@ -309,6 +416,9 @@ public:
 	virtual ARFloat executeSingleMarkerPoseEstimator(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4]);
 
 
+	virtual int executeSingleMarkerPoseEstimatorBatch(ARMarkerInfo *marker_info, int marker_num, ARFloat center[2], ARFloat width, ARFloat conv[][3][4], ARFloat err[]);
+
+
 	virtual ARFloat executeMultiMarkerPoseEstimator(ARMarkerInfo *marker_info, int marker_num, ARMultiMarkerInfoT *config);
 
 
@@ -331,19 +441,25 @@ protected:
 	static bool convertProjectionMatrixToOpenGLStyle2(ARFloat cparam[3][4], int width, int height, ARFloat gnear, ARFloat gfar, ARFloat m[16]);
 
 
-	ARMarkerInfo2* arDetectMarker2(ARInt16 *limage, int label_num, int *label_ref,
+	ARMarkerInfo2* arDetectMarker2(ARLabel *limage, int label_num, int *label_ref,
 								   int *warea, ARFloat *wpos, int *wclip,
 								   int area_max, int area_min, ARFloat factor, int *marker_num);
 
-	int arGetContour(ARInt16 *limage, int *label_ref, int label, int clip[4], ARMarkerInfo2 *marker_infoTWO);
+	int arGetContour(ARLabel *limage, int *label_ref, int label, int clip[4], ARMarkerInfo2 *marker_infoTWO);
 
 	int check_square(int area, ARMarkerInfo2 *marker_infoTWO, ARFloat factor);
 
+	// nPara optionally passes the quad homography from arCheckBorder() on
 	int arGetCode(ARUint8 *image, int *x_coord, int *y_coord, int *vertex,
-				  int *code, int *dir, ARFloat *cf, int thresh);
+				  int *code, int *dir, ARFloat *cf, int thresh, const ARFloat (*nPara)[3]=NULL);
 
 	int arGetPatt(ARUint8 *image, int *x_coord, int *y_coord, int *vertex,
-				  ARUint8 ext_pat[PATTERN_HEIGHT][PATTERN_WIDTH][3]);
+				  ARUint8 ext_pat[PATTERN_HEIGHT][PATTERN_WIDTH][3], const ARFloat (*nPara)[3]=NULL);
+
+	// also returns the quad homography in para for arGetCode()
+	int arCheckBorder(ARUint8 *image, int *x_coord, int *y_coord, int *vertex, int thresh, ARFloat para[3][3]);
+
+	bool isIdAllowed(int nId) const  {  return nId>=0 && nId<AR_ID_FILTER_MAX && ((idFilter[nId>>5]>>(nId&31))&1)!=0;  }
 
 	int pattern_match( ARUint8 *data, int *code, int *dir, ARFloat *cf);
 
@@ -353,9 +469,15 @@ protected:
 
 	int bitfield_check_BCH(ARUint8 *data, int *code, int *dir, ARFloat *cf, int thresh);
 
+	int bitfield_check_dictionary(ARUint8 *data, int *code, int *dir, ARFloat *cf, int thresh);
+
 	void gen_evec(void);
 
-	ARMarkerInfo* arGetMarkerInfo(ARUint8 *image, ARMarkerInfo2 *marker_info2, int *marker_num, int thresh);
+	ARMarkerInfo* arGetMarkerInfo(ARUint8 *image, ARMarkerInfo2 *marker_info2, int *marker_num, int thresh, bool nUseHistory=false);
+
+	bool continuesTrack(const arPrevInfo& nTrack, int nArea, const ARFloat nPos[2]) const;
+
+	int findReusableTrack(ARMarkerInfo2 *marker_info2, int marker_num, int nCandidate) const;
 
 	ARFloat arGetTransMat2(ARFloat rot[3][3], ARFloat ppos2d[][2], ARFloat ppos3d[][2], int num, ARFloat conv[3][4]);
 
@@ -388,27 +510,66 @@ protected:
 
 	int arGetInitRot(ARMarkerInfo *marker_info, ARFloat cpara[3][4], ARFloat rot[3][3]);
 
+	int arGetInitPoseIPPE(ARFloat ppos2d[4][2], ARFloat width, ARFloat cpara[3][4], ARFloat rot[2][3][3], ARFloat trans[2][3], ARFloat err[2]);
+
 
 	ARFloat arGetTransMatCont2(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4]);
 
 	ARFloat arGetTransMatContSub(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat center[2], ARFloat width, ARFloat conv[3][4]);
 
+	ARFloat rppGetTransMatSub(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat center[2], ARFloat width, ARFloat conv[3][4]);
+
+	ARFloat lmGetTransMatSub(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat center[2], ARFloat width, ARFloat conv[3][4]);
+
+	ARFloat arGetInitPoseEPnP(ARFloat ppos2d[][2], ARFloat ppos3d[][3], int num, ARFloat conv[3][4]);
+
+	ARFloat arRefinePoseLM(ARFloat ppos2d[][2], ARFloat ppos3d[][3], int num, ARFloat conv[3][4]);
+
+	// runs the current pose estimator, warm started from prev_conv if that is not NULL.
+	// prev_err is the fit error of prev_conv (<0 if unknown)
+	ARFloat estimateSingleMarkerPose(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat prev_err, ARFloat center[2], ARFloat width, ARFloat conv[3][4]);
+
+	// POSE_ESTIMATOR_AUTO, returns the mean squared reprojection error of the chosen pose
+	ARFloat estimateSingleMarkerPoseAuto(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat prev_err, ARFloat center[2], ARFloat width, ARFloat conv[3][4]);
+
+	// true if the marker's pose is likely ambiguous, so that RPP is worth its cost
+	bool isMarkerPoseAmbiguous(ARMarkerInfo *marker_info, ARFloat prev_err);
+
+	// mean squared distance (pixels) between the marker's corners and their projection through conv
+	ARFloat getMarkerFitError(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4]);
 
+	bool usePoseHistory() const  {  return poseHistoryEnabled || poseEstimator==POSE_ESTIMATOR_ORIGINAL_CONT || poseEstimator==POSE_ESTIMATOR_AUTO;  }
 
-	ARInt16* arLabeling(ARUint8 *image, int thresh,int *label_num, int **area,
+	// returns the remembered pose of marker nId or NULL; its fit error is written to nErr
+	ARFloat (*findPoseHistory(int nId, ARFloat *nErr=NULL))[4];
+
+	void storePoseHistory(int nId, ARFloat conv[3][4], ARFloat err);
+
+	// feeds a single marker pose into the pose filter
+	void updatePoseFilter(int nId, ARFloat center[2], ARFloat width, ARFloat conv[3][4], ARFloat err);
+
+	// projects the bounding sphere of target nId of nFilter, predicted for nTime, into the image
+	bool getPredictedBox(const PoseFilter& nFilter, int nId, double nTime, int nBox[4]);
+
+	// advances the frame time and sets up the search region of the new image (see activatePredictedSearch())
+	void beginFrame();
+
+
+
+	ARLabel* arLabeling(ARUint8 *image, int thresh,int *label_num, int **area,
 						ARFloat **pos, int **clip, int **label_ref );
 
 
-	ARInt16* arLabeling_ABGR(ARUint8 *image, int thresh,int *label_num, int **area, ARFloat **pos, int **clip, int **label_ref);
-	ARInt16* arLabeling_BGR(ARUint8 *image, int thresh,int *label_num, int **area, ARFloat **pos, int **clip, int **label_ref);
-	ARInt16* arLabeling_RGB(ARUint8 *image, int thresh,int *label_num, int **area, ARFloat **pos, int **clip, int **label_ref);
-	ARInt16* arLabeling_RGB565(ARUint8 *image, int thresh,int *label_num, int **area, ARFloat **pos, int **clip, int **label_ref);
-	ARInt16* arLabeling_LUM(ARUint8 *image, int thresh,int *label_num, int **area, ARFloat **pos, int **clip, int **label_ref);
+	ARLabel* arLabeling_ABGR(ARUint8 *image, int thresh,int *label_num, int **area, ARFloat **pos, int **clip, int **label_ref);
+	ARLabel* arLabeling_BGR(ARUint8 *image, int thresh,int *label_num, int **area, ARFloat **pos, int **clip, int **label_ref);
+	ARLabel* arLabeling_RGB(ARUint8 *image, int thresh,int *label_num, int **area, ARFloat **pos, int **clip, int **label_ref);
+	ARLabel* arLabeling_RGB565(ARUint8 *image, int thresh,int *label_num, int **area, ARFloat **pos, int **clip, int **label_ref);
+	ARLabel* arLabeling_LUM(ARUint8 *image, int thresh,int *label_num, int **area, ARFloat **pos, int **clip, int **label_ref);
 
-	//ARInt16* labeling2(ARUint8 *image, int thresh,int *label_num, int **area,
+	//ARLabel* labeling2(ARUint8 *image, int thresh,int *label_num, int **area,
 	//				   ARFloat **pos, int **clip, int **label_ref, int LorR );
 
-	//ARInt16* labeling3(ARUint8 *image, int thresh, int *label_num, int **area,
+	//ARLabel* labeling3(ARUint8 *image, int thresh, int *label_num, int **area,
 	//				   ARFloat **pos, int **clip, int **label_ref, int LorR );
 
 
@@ -420,6 +581,13 @@ protected:
 
 	int arMultiDeactivate( ARMultiMarkerInfoT *config );
 
+	/// Builds the id lookup tables and work buffers of a freshly loaded multi-marker config
+	/**
+	 *  arMultiGetTransMat() and rppMultiGetTransMat() use these instead of allocating
+	 *  per frame. Returns -1 if out of memory.
+	 */
+	int arMultiSetupLookup(ARMultiMarkerInfoT *config, const ARInt32 *idToMarker=NULL);
+
 	int verify_markers(ARMarkerInfo *marker_info, int marker_num, ARMultiMarkerInfoT *config);
 
 	int arInitCparam( Camera *pCam );
@@ -448,7 +616,12 @@ protected:
 
 	int arParamObserv2Ideal_LUT(Camera* pCam, ARFloat ox, ARFloat oy, ARFloat *ix, ARFloat *iy);
 
+	int arParamObserv2Ideal_LUTSparse(Camera* pCam, ARFloat ox, ARFloat oy, ARFloat *ix, ARFloat *iy);
+
 	int arParamObserv2Ideal_std(Camera* pCam, ARFloat ox, ARFloat oy, ARFloat *ix, ARFloat *iy);
+
+	// undistorts nNum points with the current undistortion mode, choosing it once for all points
+	void arParamObserv2IdealBatch(Camera* pCam, int nNum, const ARFloat* nOx, const ARFloat* nOy, ARFloat* nIx, ARFloat* nIy);
 	int arParamIdeal2Observ_std(Camera* pCam, ARFloat ix, ARFloat iy, ARFloat *ox, ARFloat *oy);
 
 	typedef int (TrackerImpl::* ARPARAM_UNDIST_FUNC)(Camera* pCam, ARFloat ox, ARFloat oy, ARFloat *ix, ARFloat *iy);
@@ -458,6 +631,23 @@ protected:
 
 	void buildUndistO2ITable(Camera* pCam);
 
+	void freeUndistO2ITable();
+
+	// identifies the undistortion of pCam at the current image size (see ARUndistLUTHeader)
+	ARUint32 hashUndistortion(Camera* pCam);
+
+	// maps the cache file, returns false if it is missing or does not match nHash
+	bool loadUndistLUTCache(const char* nFileName, ARUint32 nHash);
+
+	bool saveUndistLUTCache(const char* nFileName, ARUint32 nHash);
+
+	// falls back to UNDIST_STD if the undistorted image does not fit the table encoding
+	bool checkUndistTableRange(Camera* pCam);
+
+	void buildUndistSparseTable(Camera* pCam);
+
+	void freeUndistTables();
+
 	void checkRGB565LUT();
 
 	// calculates amount of data that will be allocated via artkp_Alloc()
@@ -551,6 +741,10 @@ protected:
     int						arGetContour_wx[AR_CHAIN_MAX];
     int						arGetContour_wy[AR_CHAIN_MAX];
 
+	// arUtil.cpp: contour points of one side of a marker before and after undistortion
+	ARFloat					*arGetLine_ox, *arGetLine_oy;		//[AR_CHAIN_MAX]	// dyna
+	ARFloat					*arGetLine_ix, *arGetLine_iy;		//[AR_CHAIN_MAX]	// dyna
+
 
 	// arGetCode.cpp
 	int    pattern_num;
@@ -568,27 +762,24 @@ protected:
 	ARFloat epatBW[MAX_LOAD_PATTERNS][4][EVEC_MAX];
 	int    evec_dimBW;
 	int    evecBWf;
+	bool   evecDirty;		// pattern library changed since the last gen_evec()
 
 	// arGetMarkerInfo.cpp
 	//
 	ARMarkerInfo    marker_infoL[MAX_IMAGE_PATTERNS];
-
-	// arGetTransMat.cpp
-	//
-	ARFloat  pos2d[P_MAX][2];
-	ARFloat  pos3d[P_MAX][3];
+	int             marker_reuseL[MAX_IMAGE_PATTERNS];		// arPrevInfo::reuse for each entry of marker_infoL
 
 	// arLabeling.cpp
 	//
-	ARInt16      *l_imageL; //[HARDCODED_BUFFER_WIDTH*HARDCODED_BUFFER_HEIGHT];		// dyna
-	ARInt16      *l_imageR;
+	ARLabel      *l_imageL; //[HARDCODED_BUFFER_WIDTH*HARDCODED_BUFFER_HEIGHT];		// dyna
+	ARLabel      *l_imageR;
 	int			 l_imageL_size;
 
 	int          *workL;  //[WORK_SIZE];											// dyna
-	int          *work2L; //[WORK_SIZE*7];											// dyna
+	ARLabelSum   *work2L; //[WORK_SIZE*7];											// dyna
 
 	int          *workR;
-	int          *work2R;
+	ARLabelSum   *work2R;
 	int          *wareaR;
 	int          *wclipR;
 	ARFloat      *wposR;
@@ -604,6 +795,7 @@ protected:
 	Camera	   *arCamera;
 	bool		loadCachedUndist;
 	int        arImXsize, arImYsize;
+	int        arAreaMax;					// AR_AREA_MAX scaled to the image size (see arInitCparam())
 	int        arTemplateMatchingMode;
 	int        arMatchingPCAMode;
 
@@ -617,12 +809,47 @@ protected:
 	// camera distortion addon by Daniel
 	//
 	UNDIST_MODE		undistMode;
-	unsigned int	*undistO2ITable;
+	ARUndistEntry	*undistO2ITable;
+	MappedFile		undistLUTFile;					// backs undistO2ITable if it was loaded from the cache
+	ARUndistEntry	*undistSparseTable;				// one entry every AR_UNDIST_SPARSE_STEP pixels
+	int				undistSparseXsize, undistSparseYsize;
 	//unsigned int	*undistI2OTable;
 
 
 	ARFloat			relBorderWidth;
 
+	bool			decodeBeforeFit;
+	bool			borderCheck;
+
+	bool			idFilterEnabled;
+	unsigned int	idFilter[AR_ID_FILTER_MAX/32];
+
+	bool			idReuse;
+	int				idReuseInterval;
+
+	struct PoseHistoryEntry {
+		int			id;
+		int			frame;
+		ARFloat		err;
+		ARFloat		trans[3][4];
+	};
+
+	PoseHistoryEntry	poseHistory[MAX_IMAGE_PATTERNS];
+	int					poseHistoryFrame;
+	bool				poseHistoryEnabled;
+
+	PoseFilter			poseFilter;				// one target per marker id
+	const PoseFilter	*searchFilter;			// targets used for the predicted search
+	bool				poseFilterEnabled;
+	double				frameTime, prevFrameTime, nextFrameTime;
+	bool				nextFrameTimeSet;
+
+	bool				predictedSearch;
+	int					predictedSearchCountdown;	// frames until the next full image search
+	bool				searchROIActive;
+	int					searchROI[4];			// minX, minY, maxX, maxY in image pixels
+	int					labelROI[4];			// minX, maxX, minY, maxY labeled by arLabeling() (in label image coordinates)
+
 	ARPARAM_UNDIST_FUNC arParamObserv2Ideal_func;
 	//ARPARAM_UNDIST_FUNC arParamIdeal2Observ_func;
 
@@ -633,7 +860,7 @@ protected:
 
 	ARToolKitPlus::Logger	*logger;
 
-	static int				screenWidth, screenHeight;
+	int						screenWidth, screenHeight;	// frame size of this tracker's camera
 	int						thresh;
 
 	ARParam					cparam;
@@ -649,6 +876,7 @@ protected:
 	} vignetting;
 
 	BCH						*bchProcessor;
+	MarkerDictionary		*markerDictionary;
 	Profiler				profiler;
 };
 
@@ -664,17 +892,21 @@ protected:
 #include "../../src/core/arDetectMarker.cxx"
 #include "../../src/core/arDetectMarker2.cxx"
 #include "../../src/core/arGetCode.cxx"
+#include "../../src/core/arPattBundle.cxx"
 #include "../../src/core/arGetMarkerInfo.cxx"
 #include "../../src/core/arGetTransMat.cxx"
 #include "../../src/core/arGetTransMat2.cxx"
 #include "../../src/core/arGetTransMat3.cxx"
 #include "../../src/core/rppGetTransMat.cxx" // RPP integration -- [t.pintaric]
 #include "../../src/core/arGetTransMatCont.cxx"
+#include "../../src/core/lmGetTransMat.cxx"
 #include "../../src/core/arLabeling.cxx"
 #include "../../src/core/arMultiActivate.cxx"
 #include "../../src/core/arMultiGetTransMat.cxx"
 #include "../../src/core/rppMultiGetTransMat.cxx" 	// RPP integration -- [t.pintaric]
+#include "../../src/core/lmMultiGetTransMat.cxx"
 #include "../../src/core/arMultiReadConfigFile.cxx"
+#include "../../src/core/arMultiBoard.cxx"
 #include "../../src/core/arUtil.cxx"
 #include "../../src/core/matrix.cxx"
 #include "../../src/core/mPCA.cxx"
@@ -689,6 +921,7 @@ protected:
 #include "../../src/CameraAdvImpl.cxx"
 #include "../../src/CameraFactory.cxx"
 #include "../../src/extra/BCH.cxx"
+#include "../../src/extra/MarkerDictionary.cxx"
 
 #include "../../src/TrackerImpl.cxx"
 //#include "../../src/extra/harrisCornerDetector.cxx"
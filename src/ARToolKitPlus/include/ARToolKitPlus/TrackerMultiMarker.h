@@ -74,6 +74,8 @@ public:
 	/// calculates the transformation matrix
 	/**
 	 *	pass the image as RGBX (32-bits) in 320x240 pixels.
+	 *  Returns the number of detected markers or 0 if none of the loaded
+	 *  multi-marker configs could be tracked.
 	 */
 	virtual int calc(const unsigned char* nImage) = 0;
 
@@ -104,6 +106,55 @@ public:
 	 */
 	virtual const ARMultiMarkerInfoT* getMultiMarkerConfig() const = 0;
 
+	/// Loads an additional multi-marker config file
+	/**
+	 *  All loaded configs are tracked from the same detection pass: calc() labels
+	 *  and decodes the image only once and then estimates one pose per config.
+	 *  The config loaded by init() always has index 0; init() removes all configs
+	 *  added by this method. Returns the index of the new config or -1 on failure
+	 *  (at most AR_MULTI_MAX_CONFIGS configs are supported).
+	 */
+	virtual int addMultiMarkerConfig(const char* nMultiFile) = 0;
+
+	/// Replaces the multi-marker config with index nConfig by the one in nMultiFile
+	/**
+	 *  Text configs and compiled boards are both accepted. The old config is
+	 *  only released if the new one could be loaded, so tracking continues
+	 *  with the old board on failure. The tracking state of the config (the
+	 *  previous pose) is reset. Must not be called concurrently with calc().
+	 */
+	virtual bool replaceMultiMarkerConfig(int nConfig, const char* nMultiFile) = 0;
+
+	/// Returns the number of loaded multi-marker configs
+	virtual int getNumMultiMarkerConfigs() const = 0;
+
+	/// Returns the loaded ARMultiMarkerInfoT object with index nConfig or NULL
+	virtual const ARMultiMarkerInfoT* getMultiMarkerConfig(int nConfig) const = 0;
+
+	/// Returns true if the config with index nConfig was tracked in the last calc() call
+	virtual bool isMultiMarkerConfigTracked(int nConfig) const = 0;
+
+	/// Returns the OpenGL style transformation matrix of the config with index nConfig
+	/**
+	 *  This is the per-config version of getModelViewMatrix(). The matrix is only
+	 *  updated in frames in which the config was tracked.
+	 */
+	virtual const ARFloat* getMultiMarkerModelViewMatrix(int nConfig) const = 0;
+
+	/// Returns ARToolKit's transformation matrix of the config with index nConfig
+	virtual void getARMatrix(int nConfig, ARFloat nMatrix[3][4]) const = 0;
+
+	/// Returns the filtered pose of config nConfig extrapolated to time nTime
+	/**
+	 *  With the pose filter enabled (see Tracker::activatePoseFilter()) every tracked
+	 *  config is filtered like a single marker. Returns false if the pose filter is
+	 *  disabled or the config was not tracked within AR_POSE_FILTER_MAX_GAP seconds before nTime.
+	 */
+	virtual bool getFilteredConfigPose(int nConfig, double nTime, ARFloat nTrans[3][4]) = 0;
+
+	/// Returns the image space bounding box (minX, minY, maxX, maxY) config nConfig is expected at for time nTime
+	virtual bool getPredictedConfigBox(int nConfig, double nTime, int nBox[4]) = 0;
+
 
 	/// Provides access to ARToolKit' internal version of the transformation matrix
 	/**
@@ -105,6 +105,27 @@ public:
 
 	virtual const ARMultiMarkerInfoT* getMultiMarkerConfig() const  {  return config;  }
 
+	virtual int addMultiMarkerConfig(const char* nMultiFile);
+
+	virtual bool replaceMultiMarkerConfig(int nConfig, const char* nMultiFile);
+
+	virtual int getNumMultiMarkerConfigs() const  {  return numConfigs;  }
+
+	virtual const ARMultiMarkerInfoT* getMultiMarkerConfig(int nConfig) const  {  return (nConfig>=0 && nConfig<numConfigs) ? configs[nConfig] : NULL;  }
+
+	virtual bool isMultiMarkerConfigTracked(int nConfig) const  {  return nConfig>=0 && nConfig<numConfigs && configErr[nConfig]>=0.0f;  }
+
+	virtual const ARFloat* getMultiMarkerModelViewMatrix(int nConfig) const  {  return (nConfig>=0 && nConfig<numConfigs) ? configGLPara[nConfig] : NULL;  }
+
+	virtual void getARMatrix(int nConfig, ARFloat nMatrix[3][4]) const;
+
+	virtual bool getFilteredConfigPose(int nConfig, double nTime, ARFloat nTrans[3][4])  {  return this->poseFilterEnabled && configFilter.getPose(nConfig, nTime, nTrans);  }
+
+	virtual bool getPredictedConfigBox(int nConfig, double nTime, int nBox[4])  {  return this->poseFilterEnabled && this->getPredictedBox(configFilter, nConfig, nTime, nBox);  }
+
+	/// Smoothes the marker and config poses over time and allows to predict them
+	virtual void activatePoseFilter(bool nEnable, ARFloat nAlpha=AR_POSE_FILTER_ALPHA, ARFloat nBeta=AR_POSE_FILTER_BETA);
+
 	/// Provides access to ARToolKit' internal version of the transformation matrix
 	/**
 	*  This method is primarily for compatibility issues with code previously using
@@ -132,17 +153,43 @@ public:
 	ARFloat arGetTransMatCont(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat center[2], ARFloat width, ARFloat conv[3][4])  {  return AR_TEMPL_TRACKER::arGetTransMatCont(marker_info, prev_conv, center, width, conv);  }
 	ARFloat rppMultiGetTransMat(ARMarkerInfo *marker_info, int marker_num, ARMultiMarkerInfoT *config)  {  return AR_TEMPL_TRACKER::rppMultiGetTransMat(marker_info, marker_num, config);  }
 	ARFloat rppGetTransMat(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4])  {  return AR_TEMPL_TRACKER::rppGetTransMat(marker_info, center, width, conv);  }
+	ARFloat rppGetTransMatCont(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat center[2], ARFloat width, ARFloat conv[3][4])  {  return AR_TEMPL_TRACKER::rppGetTransMatCont(marker_info, prev_conv, center, width, conv);  }
+	ARFloat lmMultiGetTransMat(ARMarkerInfo *marker_info, int marker_num, ARMultiMarkerInfoT *config)  {  return AR_TEMPL_TRACKER::lmMultiGetTransMat(marker_info, marker_num, config);  }
+	ARFloat lmGetTransMat(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4])  {  return AR_TEMPL_TRACKER::lmGetTransMat(marker_info, center, width, conv);  }
+	ARFloat lmGetTransMatCont(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat center[2], ARFloat width, ARFloat conv[3][4])  {  return AR_TEMPL_TRACKER::lmGetTransMatCont(marker_info, prev_conv, center, width, conv);  }
 	int arLoadPatt(char *filename)  {  return AR_TEMPL_TRACKER::arLoadPatt(filename);  }
 	int arFreePatt(int patno)  {  return AR_TEMPL_TRACKER::arFreePatt(patno);  }
+	int arLoadPattBundle(const char *filename)  {  return AR_TEMPL_TRACKER::arLoadPattBundle(filename);  }
+	int arSavePattBundle(const char *filename)  {  return AR_TEMPL_TRACKER::arSavePattBundle(filename);  }
 	int arMultiFreeConfig(ARMultiMarkerInfoT *config)  {  return AR_TEMPL_TRACKER::arMultiFreeConfig(config);  }
 	ARMultiMarkerInfoT *arMultiReadConfigFile(const char *filename)  {  return AR_TEMPL_TRACKER::arMultiReadConfigFile(filename);  }
+	ARMultiMarkerInfoT *arMultiReadConfigBinary(const char *filename)  {  return AR_TEMPL_TRACKER::arMultiReadConfigBinary(filename);  }
+	int arMultiSaveConfigBinary(ARMultiMarkerInfoT *config, const char *filename)  {  return AR_TEMPL_TRACKER::arMultiSaveConfigBinary(config, filename);  }
 	void activateBinaryMarker(int nThreshold)  {  AR_TEMPL_TRACKER::activateBinaryMarker(nThreshold);  }
+	void activatePCAMatching(bool nEnable)  {  AR_TEMPL_TRACKER::activatePCAMatching(nEnable);  }
+	bool isPCAMatchingActivated() const  {  return AR_TEMPL_TRACKER::isPCAMatchingActivated();  }
 	void setMarkerMode(MARKER_MODE nMarkerMode)  {  AR_TEMPL_TRACKER::setMarkerMode(nMarkerMode);  }
+	int generateMarkerDictionary(int nGridSize, int nNumMarkers, int nMinDistance)  {  return AR_TEMPL_TRACKER::generateMarkerDictionary(nGridSize, nNumMarkers, nMinDistance);  }
+	bool loadMarkerDictionary(const char* nFileName)  {  return AR_TEMPL_TRACKER::loadMarkerDictionary(nFileName);  }
+	bool saveMarkerDictionary(const char* nFileName)  {  return AR_TEMPL_TRACKER::saveMarkerDictionary(nFileName);  }
 	void activateVignettingCompensation(bool nEnable, int nCorners=0, int nLeftRight=0, int nTopBottom=0)  {  AR_TEMPL_TRACKER::activateVignettingCompensation(nEnable, nCorners, nLeftRight, nTopBottom);  }
 	void changeCameraSize(int nWidth, int nHeight)  {  AR_TEMPL_TRACKER::changeCameraSize(nWidth, nHeight);  }
 	void setUndistortionMode(UNDIST_MODE nMode)  {  AR_TEMPL_TRACKER::setUndistortionMode(nMode);  }
 	bool setPoseEstimator(POSE_ESTIMATOR nMethod) {  return AR_TEMPL_TRACKER::setPoseEstimator(nMethod);  }
 	void setBorderWidth(ARFloat nFraction)  {  AR_TEMPL_TRACKER::setBorderWidth(nFraction);  }
+	void activateDecodeBeforeFit(bool nEnable)  {  AR_TEMPL_TRACKER::activateDecodeBeforeFit(nEnable);  }
+	void activateBorderCheck(bool nEnable)  {  AR_TEMPL_TRACKER::activateBorderCheck(nEnable);  }
+	void activateIdFilter(bool nEnable)  {  AR_TEMPL_TRACKER::activateIdFilter(nEnable);  }
+	bool setIdFilterEntry(int nId, bool nAllowed)  {  return AR_TEMPL_TRACKER::setIdFilterEntry(nId, nAllowed);  }
+	void clearIdFilter()  {  AR_TEMPL_TRACKER::clearIdFilter();  }
+	void activateIdReuse(bool nEnable, int nDecodeInterval=10)  {  AR_TEMPL_TRACKER::activateIdReuse(nEnable, nDecodeInterval);  }
+
+	void activatePoseHistory(bool nEnable)  {  AR_TEMPL_TRACKER::activatePoseHistory(nEnable);  }
+	void setFrameTime(double nTime)  {  AR_TEMPL_TRACKER::setFrameTime(nTime);  }
+	double getFrameTime() const  {  return AR_TEMPL_TRACKER::getFrameTime();  }
+	bool getFilteredMarkerPose(int nId, double nTime, ARFloat nTrans[3][4])  {  return AR_TEMPL_TRACKER::getFilteredMarkerPose(nId, nTime, nTrans);  }
+	bool getPredictedMarkerBox(int nId, double nTime, int nBox[4])  {  return AR_TEMPL_TRACKER::getPredictedMarkerBox(nId, nTime, nBox);  }
+	void activatePredictedSearch(bool nEnable)  {  AR_TEMPL_TRACKER::activatePredictedSearch(nEnable);  }
 	void setThreshold(int nValue)  {  AR_TEMPL_TRACKER::setThreshold(nValue);  }
 	int getThreshold() const  {  return AR_TEMPL_TRACKER::getThreshold();  }
 	void activateAutoThreshold(bool nEnable)  {  AR_TEMPL_TRACKER::activateAutoThreshold(nEnable);  }
@@ -161,6 +208,7 @@ public:
 	void setCamera(Camera* nCamera, ARFloat nNearClip, ARFloat nFarClip)  {  AR_TEMPL_TRACKER::setCamera(nCamera, nNearClip, nFarClip);  }
 	ARFloat calcOpenGLMatrixFromMarker(ARMarkerInfo* nMarkerInfo, ARFloat nPatternCenter[2], ARFloat nPatternSize, ARFloat *nOpenGLMatrix)  {  return AR_TEMPL_TRACKER::calcOpenGLMatrixFromMarker(nMarkerInfo, nPatternCenter, nPatternSize, nOpenGLMatrix);  }
 	ARFloat executeSingleMarkerPoseEstimator(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4])  {  return AR_TEMPL_TRACKER::executeSingleMarkerPoseEstimator(marker_info, center, width, conv);  }
+	int executeSingleMarkerPoseEstimatorBatch(ARMarkerInfo *marker_info, int marker_num, ARFloat center[2], ARFloat width, ARFloat conv[][3][4], ARFloat err[])  {  return AR_TEMPL_TRACKER::executeSingleMarkerPoseEstimatorBatch(marker_info, marker_num, center, width, conv, err);  }
 	ARFloat executeMultiMarkerPoseEstimator(ARMarkerInfo *marker_info, int marker_num, ARMultiMarkerInfoT *config)  {  return AR_TEMPL_TRACKER::executeMultiMarkerPoseEstimator(marker_info, marker_num, config);  }
 
 	static void* operator new(size_t size);
@@ -173,7 +221,24 @@ protected:
 	int				numDetected;
 	bool			useDetectLite;
 
-	ARMultiMarkerInfoT  *config;
+	ARMultiMarkerInfoT  *config;								// always the same as configs[0]
+
+	int					numConfigs;
+	ARMultiMarkerInfoT	*configs[AR_MULTI_MAX_CONFIGS];
+	ARFloat				configErr[AR_MULTI_MAX_CONFIGS];		// result of the last pose estimation, <0 if not tracked
+	ARFloat				configGLPara[AR_MULTI_MAX_CONFIGS][16];
+
+	// verify_markers() relabels markers in place, so every config but the
+	// first one works on its own copy of the detected markers.
+	ARMarkerInfo		configMarkers[AR_MULTI_MAX_CONFIGS-1][AR_TEMPL_TRACKER::MAX_IMAGE_PATTERNS];
+
+	void freeConfigs();
+
+	// one target per config, also used for the predicted search
+	PoseFilter			configFilter;
+
+	// feeds the pose of config nConfig into configFilter
+	void updateConfigFilter(int nConfig);
 
 	int				detectedMarkerIDs[AR_TEMPL_TRACKER::MAX_IMAGE_PATTERNS];
 	ARMarkerInfo	detectedMarkers[AR_TEMPL_TRACKER::MAX_IMAGE_PATTERNS];
@@ -79,6 +79,12 @@ public:
 	 */
 	virtual int addPattern(const char* nFileName) = 0;
 
+	/// adds all patterns of a compiled pattern bundle to ARToolKit
+	/**
+	 *  returns the id of the first pattern, see Tracker::arLoadPattBundle()
+	 */
+	virtual int addPatternBundle(const char* nFileName) = 0;
+
 	/// calculates the transformation matrix
 	/**
 	 *	pass the image as RGBX (32-bits) in 320x240 pixels.
@@ -68,6 +68,22 @@ typedef unsigned short    ARUint16;
 typedef unsigned int      ARUint32;
 
 
+// entries of the label image and the sums (area, coordinates) collected
+// per label. images above 32767 labels or with markers large enough to
+// overflow 32 bit coordinate sums need AR_HIGH_RESOLUTION (see config.h).
+#ifdef AR_HIGH_RESOLUTION
+typedef ARInt32           ARLabel;
+#  if defined(_MSC_VER) || defined(_WIN32_WCE)
+typedef __int64           ARLabelSum;
+#  else
+typedef long long         ARLabelSum;
+#  endif
+#else
+typedef ARInt16           ARLabel;
+typedef int               ARLabelSum;
+#endif //AR_HIGH_RESOLUTION
+
+
 typedef struct {
     int     area;
     int     id;
@@ -92,6 +108,7 @@ typedef struct {
 typedef struct {
     ARMarkerInfo  marker;
     int     count;
+    int     reuse;			// number of frames the id was reused without decoding
 } arPrevInfo;
 
 
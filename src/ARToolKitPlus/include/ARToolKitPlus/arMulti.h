@@ -63,13 +63,31 @@ typedef struct {
     int     visibleR;
 } ARMultiEachMarkerInfoT;
 
+typedef struct {
+    ARFloat   pos[4][2];
+    ARFloat   thresh;
+    ARFloat   err;
+    int      marker;
+    int      dir;
+} arMultiEachMarkerInternalInfoT;
+
 typedef struct {
     ARMultiEachMarkerInfoT  *marker;
     int                     marker_num;
     ARFloat                  trans[3][4];
     int                     prevF;
+    int                     ownsPatterns;    // arMultiFreeConfig() also frees the markers' patterns
 /*---*/
     ARFloat                  transR[3][4];
+/*--- lookup tables and work buffers, see arMultiSetupLookup() ---*/
+    int                     idTableSize;     // largest patt_id + 1
+    int                     *idToMarker;     // patt_id -> first config marker with that id, or -1
+    int                     *idScratch;      // patt_id -> detected marker, only valid during a call (-1 otherwise)
+    ARFloat                  *pos2d;         // 4 image points per config marker
+    ARFloat                  *pos3d;         // 4 model points per config marker
+    double                   (*rppPos2d)[3];
+    double                   (*rppPos3d)[3];
+    arMultiEachMarkerInternalInfoT *winfo;   // used by verify_markers()
 } ARMultiMarkerInfoT;
 
 
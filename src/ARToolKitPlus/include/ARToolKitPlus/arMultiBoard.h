@@ -0,0 +1,99 @@
+/* ========================================================================
+* PROJECT: ARToolKitPlus
+* ========================================================================
+* This work is based on the original ARToolKit developed by
+*   Hirokazu Kato
+*   Mark Billinghurst
+*   HITLab, University of Washington, Seattle
+* http://www.hitl.washington.edu/artoolkit/
+*
+* Copyright of the derived and new portions of this work
+*     (C) 2006 Graz University of Technology
+*
+* This framework is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this framework; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+* For further information please contact 
+*   Dieter Schmalstieg
+*   <schmalstieg@icg.tu-graz.ac.at>
+*   Graz University of Technology, 
+*   Institut for Computer Graphics and Vision,
+*   Inffeldgasse 16a, 8010 Graz, Austria.
+* ========================================================================
+*
+* $Id$
+* @file
+* ======================================================================== */
+
+
+#ifndef __ARMULTIBOARD_HEADERFILE__
+#define __ARMULTIBOARD_HEADERFILE__
+
+
+#include <ARToolKitPlus/ar.h>
+
+
+namespace ARToolKitPlus {
+
+
+/// Binary multi-marker board as written by Tracker::arMultiSaveConfigBinary()
+/**
+ *  A board stores a multi-marker config in the form the tracker uses it
+ *  internally: besides each marker's id, width, center and transformation
+ *  it contains the precomputed inverse transformation, the 3d corner
+ *  positions and the id -> marker lookup table, so loading needs neither
+ *  parsing nor matrix inversion.
+ *
+ *  File layout (native byte order, no padding between sections):
+ *    ARMultiBoardHeader
+ *    numMarkers times:
+ *        ARInt32  patt_id
+ *        ARFloat  width
+ *        ARFloat  center[2]
+ *        ARFloat  trans[3][4]
+ *        ARFloat  itrans[3][4]
+ *        ARFloat  pos3d[4][3]
+ *    ARInt32  idToMarker[idTableSize]
+ *
+ *  Markers are stored by id. Markers which were given as pattern files
+ *  in the text config therefore require the same patterns to be loaded
+ *  in the same order (e.g. from a pattern bundle).
+ */
+struct ARMultiBoardHeader {
+	char		magic[4];				// "ARMB"
+	ARUint32	version;				// ARMULTIBOARD_VERSION
+	ARUint32	byteOrder;				// ARMULTIBOARD_BYTEORDER as written by the creating machine
+	ARUint32	floatSize;				// sizeof(ARFloat)
+	ARUint32	numMarkers;
+	ARUint32	idTableSize;			// largest patt_id + 1
+};
+
+
+enum {
+	ARMULTIBOARD_VERSION = 1,
+	ARMULTIBOARD_BYTEORDER = 0x01020304
+};
+
+
+inline size_t
+arMultiBoardRecordSize()
+{
+	return sizeof(ARInt32) + (1 + 2 + 12 + 12 + 12)*sizeof(ARFloat);
+}
+
+
+}  // namespace ARToolKitPlus
+
+
+#endif //__ARMULTIBOARD_HEADERFILE__
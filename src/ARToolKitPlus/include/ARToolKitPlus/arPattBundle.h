@@ -0,0 +1,99 @@
+/* ========================================================================
+* PROJECT: ARToolKitPlus
+* ========================================================================
+* This work is based on the original ARToolKit developed by
+*   Hirokazu Kato
+*   Mark Billinghurst
+*   HITLab, University of Washington, Seattle
+* http://www.hitl.washington.edu/artoolkit/
+*
+* Copyright of the derived and new portions of this work
+*     (C) 2006 Graz University of Technology
+*
+* This framework is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this framework; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+* For further information please contact 
+*   Dieter Schmalstieg
+*   <schmalstieg@icg.tu-graz.ac.at>
+*   Graz University of Technology, 
+*   Institut for Computer Graphics and Vision,
+*   Inffeldgasse 16a, 8010 Graz, Austria.
+* ========================================================================
+*
+* $Id$
+* @file
+* ======================================================================== */
+
+
+#ifndef __ARPATTBUNDLE_HEADERFILE__
+#define __ARPATTBUNDLE_HEADERFILE__
+
+
+#include <ARToolKitPlus/ar.h>
+
+
+namespace ARToolKitPlus {
+
+
+/// Binary pattern bundle as written by Tracker::arSavePattBundle()
+/**
+ *  A bundle stores a complete template library in the form the tracker uses it
+ *  internally: the patterns are already inverted, mean-free and come with their
+ *  norms (patpow/patpowBW), so loading needs no parsing and no arithmetic.
+ *  Optionally the PCA eigen-basis (evec/epat) of the library is stored too.
+ *
+ *  File layout (native byte order, no padding between sections):
+ *    ARPattBundleHeader
+ *    numPatterns times:
+ *        ARInt32  pat[4][height*width*3]
+ *        ARInt32  patBW[4][height*width]
+ *        ARFloat  patpow[4]
+ *        ARFloat  patpowBW[4]
+ *    if evecDim>0:
+ *        ARFloat  evec[evecDim][height*width*3]
+ *        ARFloat  epat[numPatterns][4][evecDim]
+ *
+ *  The header stores everything that has to match the loading tracker
+ *  (version, byte order, float size and pattern resolution). Bundles
+ *  which do not match are rejected.
+ */
+struct ARPattBundleHeader {
+	char		magic[4];				// "ARPB"
+	ARUint32	version;				// ARPATTBUNDLE_VERSION
+	ARUint32	byteOrder;				// ARPATTBUNDLE_BYTEORDER as written by the creating machine
+	ARUint32	floatSize;				// sizeof(ARFloat)
+	ARUint32	pattWidth, pattHeight;
+	ARUint32	numPatterns;
+	ARUint32	evecDim;				// 0 if no eigen-basis is stored
+};
+
+
+enum {
+	ARPATTBUNDLE_VERSION = 1,
+	ARPATTBUNDLE_BYTEORDER = 0x01020304
+};
+
+
+inline size_t
+arPattBundleRecordSize(int nWidth, int nHeight)
+{
+	return 4*nWidth*nHeight*3*sizeof(ARInt32) + 4*nWidth*nHeight*sizeof(ARInt32) + 8*sizeof(ARFloat);
+}
+
+
+}  // namespace ARToolKitPlus
+
+
+#endif //__ARPATTBUNDLE_HEADERFILE__
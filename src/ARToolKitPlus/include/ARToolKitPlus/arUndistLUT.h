@@ -0,0 +1,108 @@
+/* ========================================================================
+* PROJECT: ARToolKitPlus
+* ========================================================================
+* This work is based on the original ARToolKit developed by
+*   Hirokazu Kato
+*   Mark Billinghurst
+*   HITLab, University of Washington, Seattle
+* http://www.hitl.washington.edu/artoolkit/
+*
+* Copyright of the derived and new portions of this work
+*     (C) 2006 Graz University of Technology
+*
+* This framework is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this framework; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+* For further information please contact 
+*   Dieter Schmalstieg
+*   <schmalstieg@icg.tu-graz.ac.at>
+*   Graz University of Technology, 
+*   Institut for Computer Graphics and Vision,
+*   Inffeldgasse 16a, 8010 Graz, Austria.
+* ========================================================================
+*
+* $Id$
+* @file
+* ======================================================================== */
+
+
+#ifndef __ARUNDISTLUT_HEADERFILE__
+#define __ARUNDISTLUT_HEADERFILE__
+
+
+#include <ARToolKitPlus/ar.h>
+
+
+namespace ARToolKitPlus {
+
+
+/// Header of the undistortion table cache written next to the camera file (see Tracker::setLoadUndistLUT())
+/**
+ *  File layout (native byte order):
+ *    ARUndistLUTHeader
+ *    ARUndistEntry  table[xsize*ysize]  (row major, encoded as given by encoding)
+ *
+ *  paramHash identifies the camera model: it is computed from the undistorted
+ *  positions of a grid of image points, so it changes with any change of the
+ *  camera parameters no matter which Camera implementation is used.
+ *  A cache that does not match the current camera is rebuilt.
+ */
+struct ARUndistLUTHeader {
+	char		magic[4];				// "ALUT"
+	ARUint32	version;				// ARUNDISTLUT_VERSION
+	ARUint32	byteOrder;				// ARUNDISTLUT_BYTEORDER as written by the creating machine
+	ARUint32	encoding;				// ARUNDISTLUT_ENCODING_...
+	ARUint32	xsize, ysize;
+	ARUint32	paramHash;
+	ARUint32	reserved;				// keeps the table 8 byte aligned
+};
+
+
+enum {
+	ARUNDISTLUT_VERSION = 1,
+	ARUNDISTLUT_BYTEORDER = 0x01020304,
+	ARUNDISTLUT_ENCODING_FIXED_11_5 = 1,	// x and y as signed 11.5 fixed point in the upper and lower 16 bits
+	ARUNDISTLUT_ENCODING_FIXED_24_8 = 2		// x and y as two signed 24.8 fixed point values
+};
+
+
+/// One entry of the undistortion tables (UNDIST_LUT, UNDIST_LUT_SPARSE)
+/**
+ *  11.5 fixed point covers undistorted coordinates of up to +-1024 pixels only,
+ *  AR_HIGH_RESOLUTION builds store 24.8 fixed point in 8 bytes instead.
+ *  ARUNDISTLUT_MAX_COORD is the largest coordinate the encoding can hold.
+ */
+#ifdef AR_HIGH_RESOLUTION
+struct ARUndistEntry {
+	ARInt32		x, y;
+};
+
+enum {
+	ARUNDISTLUT_ENCODING = ARUNDISTLUT_ENCODING_FIXED_24_8,
+	ARUNDISTLUT_MAX_COORD = (1<<23)-1
+};
+#else
+typedef ARUint32 ARUndistEntry;
+
+enum {
+	ARUNDISTLUT_ENCODING = ARUNDISTLUT_ENCODING_FIXED_11_5,
+	ARUNDISTLUT_MAX_COORD = (1<<10)-1
+};
+#endif //AR_HIGH_RESOLUTION
+
+
+}  // namespace ARToolKitPlus
+
+
+#endif //__ARUNDISTLUT_HEADERFILE__
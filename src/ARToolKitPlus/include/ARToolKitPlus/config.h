@@ -61,6 +61,13 @@
 #endif
 
 
+// the default build handles images up to about 1000 pixels in each
+// direction. larger images (up to 4K) need 32 bit labels, a wider
+// undistortion table encoding and larger contour and label buffers,
+// which are enabled by AR_HIGH_RESOLUTION.
+//#define AR_HIGH_RESOLUTION
+
+
 /**
  * Endianness:
  * ususally evaluated by autoconf script, otherwise set by hand
@@ -161,21 +168,112 @@
 // constants influencing accuracy of arGetTransMat(...)
 #define   AR_GET_TRANS_MAT_MAX_LOOP_COUNT         5
 #define   AR_GET_TRANS_MAT_MAX_FIT_ERROR          1.0
+// closed form (IPPE) poses fitting better than this are used without
+// iterative refinement. set to 0 to always refine.
+#define   AR_GET_TRANS_MAT_IPPE_MAX_FIT_ERROR     1.0
 // criterium for arGetTransMatCont(...) to call 
 // arGetTransMat(...) instead
 #define   AR_GET_TRANS_CONT_MAT_MAX_FIT_ERROR     1.0
 
+// warm started RPP poses with a larger object space error are solved again from scratch
+#define   AR_GET_TRANS_RPP_CONT_MAX_FIT_ERROR     2.0
+
+// Levenberg-Marquardt pose refinement (POSE_ESTIMATOR_LM)
+#define   AR_LM_MAX_ITERATIONS                    10
+#define   AR_LM_MIN_ERROR_DECREASE                1e-4
+// multi-marker poses fitting worse than this are solved again from scratch
+#define   AR_LM_MULTI_MAX_FIT_ERROR               10.0
+// EPnP is only used if the smallest principal variance of the rig
+// is at least this fraction of the largest one (i.e. non-planar rigs)
+#define   AR_LM_EPNP_MIN_THICKNESS                1e-4
+
+// POSE_ESTIMATOR_AUTO: markers whose opposite edges differ by less than
+// AR_POSE_AUTO_MIN_PERSPECTIVE (relative, i.e. nearly fronto-parallel) and markers
+// whose previous fit error exceeded AR_POSE_AUTO_MAX_FIT_ERROR (mean squared pixels)
+// are solved with RPP. so are markers for which the cheap estimator fits worse than that.
+// markers smaller than AR_POSE_AUTO_MIN_AREA pixels never are, RPP fails on them.
+#define   AR_POSE_AUTO_MIN_AREA                   1500
+#define   AR_POSE_AUTO_MIN_PERSPECTIVE            0.03
+#define   AR_POSE_AUTO_MAX_FIT_ERROR              2.0
+
+// number of frames a marker may be missing before its pose history is dropped
+#define   AR_POSE_HISTORY_MAX_AGE                 3
+
 // min/max area of fiducial interiors to be matched
 // against templates, used in arDetectMarker.c
+// AR_AREA_MAX applies to images of up to AR_AREA_MAX_REFERENCE_PIXELS
+// pixels, for larger images it grows with the image area.
 #define   AR_AREA_MAX      100000
 #define   AR_AREA_MIN          70
+#define   AR_AREA_MAX_REFERENCE_PIXELS   (640*480)
+
+// minimum confidence value of a decoded marker, markers
+// below are reported with id -1 (see arDetectMarker.c)
+#define   AR_MIN_CONFIDENCE     0.5
+
+// used in arCheckBorder(...): number of samples taken on each side
+// of the marker border and the number of samples (out of all four
+// sides) which may be brighter than the threshold before the
+// candidate gets rejected.
+#define   AR_BORDER_CHECK_SAMPLES      8
+#define   AR_BORDER_CHECK_MAX_BRIGHT   3
+
+// size of the id filter (see Tracker::activateIdFilter()).
+// covers all BCH ids, larger ids are always filtered out.
+#define   AR_ID_FILTER_MAX      4096
+
+// used in executeSingleMarkerPoseEstimatorBatch(...): minimum number
+// of markers before the poses are estimated in parallel (only when
+// compiled with OpenMP support).
+#define   AR_BATCH_POSE_MIN_PARALLEL   4
+
+// maximum number of multi-marker configs a TrackerMultiMarker can
+// track from one detection pass (see TrackerMultiMarker::addMultiMarkerConfig()).
+#define   AR_MULTI_MAX_CONFIGS         8
+
+// pose filter (see Tracker::activatePoseFilter()): number of targets,
+// default gains, time (seconds) after which an unobserved target restarts,
+// and the frame rate assumed if Tracker::setFrameTime() is never called.
+#define   AR_POSE_FILTER_MAX_TARGETS   64
+#define   AR_POSE_FILTER_ALPHA         0.6
+#define   AR_POSE_FILTER_BETA          0.2
+#define   AR_POSE_FILTER_MAX_GAP       0.25
+#define   AR_POSE_FILTER_DEFAULT_FPS   30.0
+
+// UNDIST_LUT_SPARSE: distance (pixels) between the entries of the sparse
+// undistortion table and the interpolation error (pixels) above which
+// a warning is logged when the table is built.
+#define   AR_UNDIST_SPARSE_STEP        8
+#define   AR_UNDIST_SPARSE_MAX_ERROR   0.1
+
+// predicted search (see Tracker::activatePredictedSearch()): every
+// AR_PREDICTED_SEARCH_FULL_INTERVAL frames the full image is searched for
+// new markers. predicted boxes grow by AR_PREDICTED_SEARCH_MARGIN pixels
+// plus AR_PREDICTED_SEARCH_REL_MARGIN times their size.
+#define   AR_PREDICTED_SEARCH_FULL_INTERVAL   15
+#define   AR_PREDICTED_SEARCH_MARGIN          8
+#define   AR_PREDICTED_SEARCH_REL_MARGIN      0.25
 
 // used in arDetectMarker2(...), this param controls the
 // maximum number of potential markers evaluated further.
 // Only the first AR_SQUARE_MAX patterns are examined.
 //#define   AR_SQUARE_MAX        50
-// plays some role in arDetectMarker2 I don't understand yet
-#define   AR_CHAIN_MAX      10000
+// maximum length of a marker contour (see arGetContour()), longer
+// contours are rejected. every ARMarkerInfo2 stores this many points.
+#ifdef AR_HIGH_RESOLUTION
+#  define   AR_CHAIN_MAX      (4*(MAX_BUFFER_WIDTH+MAX_BUFFER_HEIGHT))
+#else
+#  define   AR_CHAIN_MAX      10000
+#endif
+
+// number of preliminary labels arLabeling() can handle per
+// pattern (see TrackerImpl::WORK_SIZE). larger images break up
+// into more labels.
+#ifdef AR_HIGH_RESOLUTION
+#  define   AR_LABEL_WORK_SIZE   8192
+#else
+#  define   AR_LABEL_WORK_SIZE   1024
+#endif
 // maximum number of markers that can be simultaneously loaded
 //#define   AR_PATT_NUM_MAX      50 
 
@@ -205,6 +303,9 @@
 #ifdef _WIN32_WCE
   #define MAX_BUFFER_WIDTH  320
   #define MAX_BUFFER_HEIGHT 240
+#elif defined(AR_HIGH_RESOLUTION)
+  #define MAX_BUFFER_WIDTH  3840
+  #define MAX_BUFFER_HEIGHT 2160
 #else
   #define MAX_BUFFER_WIDTH  720
   #define MAX_BUFFER_HEIGHT 576
@@ -0,0 +1,104 @@
+/* ========================================================================
+* PROJECT: ARToolKitPlus
+* ========================================================================
+* This work is based on the original ARToolKit developed by
+*   Hirokazu Kato
+*   Mark Billinghurst
+*   HITLab, University of Washington, Seattle
+* http://www.hitl.washington.edu/artoolkit/
+*
+* Copyright of the derived and new portions of this work
+*     (C) 2006 Graz University of Technology
+*
+* This framework is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this framework; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+* For further information please contact 
+*   Dieter Schmalstieg
+*   <schmalstieg@icg.tu-graz.ac.at>
+*   Graz University of Technology, 
+*   Institut for Computer Graphics and Vision,
+*   Inffeldgasse 16a, 8010 Graz, Austria.
+* ========================================================================
+*
+* $Id$
+* @file
+* ======================================================================== */
+
+
+#ifndef __ARTOOLKITPLUS_MAPPEDFILE_HEADERFILE__
+#define __ARTOOLKITPLUS_MAPPEDFILE_HEADERFILE__
+
+
+#include <stddef.h>
+
+#if defined(_MSC_VER) && !defined(_WIN32_WCE)
+#  include <windows.h>
+#endif
+
+
+namespace ARToolKitPlus {
+
+
+/// MappedFile maps a complete file read-only into memory
+/**
+ *  Where the platform supports it the file is memory mapped, so the pages
+ *  are loaded on demand and shared between all processes mapping the same file.
+ *  On other platforms (e.g. WinCE) the file is simply read into a malloc'ed block.
+ *  The data stays valid until close() is called or the object is destroyed.
+ */
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	/// Maps the file nFileName. Closes a previously opened file.
+	bool open(const char* nFileName);
+
+	/// Unmaps the file
+	void close();
+
+	bool isOpen() const  {  return data!=NULL;  }
+
+	const unsigned char* getData() const  {  return data;  }
+
+	size_t getSize() const  {  return size;  }
+
+	/// Returns a new[]'ed name next to nFileName for writing a file that replaces it later
+	/**
+	 *  The name contains the process id and nOwner, so processes and objects
+	 *  writing the same file at the same time do not share a temporary file.
+	 */
+	static char* createTempFileName(const char* nFileName, const void* nOwner);
+
+protected:
+	unsigned char*	data;
+	size_t			size;
+	bool			mapped;
+
+#if defined(_MSC_VER) && !defined(_WIN32_WCE)
+	HANDLE			hFile, hMapObject;
+#endif
+
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+};
+
+
+}  // namespace ARToolKitPlus
+
+
+#endif //__ARTOOLKITPLUS_MAPPEDFILE_HEADERFILE__
@@ -0,0 +1,160 @@
+/* ========================================================================
+* PROJECT: ARToolKitPlus
+* ========================================================================
+* This work is based on the original ARToolKit developed by
+*   Hirokazu Kato
+*   Mark Billinghurst
+*   HITLab, University of Washington, Seattle
+* http://www.hitl.washington.edu/artoolkit/
+*
+* Copyright of the derived and new portions of this work
+*     (C) 2006 Graz University of Technology
+*
+* This framework is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This framework is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this framework; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+* For further information please contact 
+*   Dieter Schmalstieg
+*   <schmalstieg@icg.tu-graz.ac.at>
+*   Graz University of Technology, 
+*   Institut for Computer Graphics and Vision,
+*   Inffeldgasse 16a, 8010 Graz, Austria.
+* ========================================================================
+*
+* $Id$
+* @file
+* ======================================================================== */
+
+
+#ifndef __ARTOOLKIT_MARKERDICTIONARY_HEADERFILE__
+#define __ARTOOLKIT_MARKERDICTIONARY_HEADERFILE__
+
+#include <ARToolKitPlus/extra/BCH.h>
+#include <vector>
+
+
+namespace ARToolKitPlus {
+
+
+// smallest and largest supported inner grid (4x4 to 6x6 bits)
+#define DICTIONARY_MIN_GRID 4
+#define DICTIONARY_MAX_GRID 6
+
+// upper limit for the number of codes in the decoding index
+#define DICTIONARY_MAX_INDEX_ENTRIES (1<<18)
+
+// largest chunk of the chunk index (2^bits buckets per chunk)
+#define DICTIONARY_MAX_CHUNK_BITS 12
+
+
+/// Dictionary of square id markers with a guaranteed minimum Hamming distance
+/**
+ *  Every marker is a grid of nGridSize x nGridSize bits (1 = white cell), stored
+ *  row by row with the top left cell in the most significant bit. The distance
+ *  between any two markers in any of their four rotations (and between the
+ *  rotations of a single marker) is at least getMinDistance(), so up to
+ *  (getMinDistance()-1)/2 wrongly read bits can be corrected.
+ *
+ *  All rotations of all markers plus all codes with up to getIndexRadius() wrong
+ *  bits are kept in a hash index. The radius is as large as the correction
+ *  capability and DICTIONARY_MAX_INDEX_ENTRIES allow. For codes with more errors
+ *  the bits are split into at least getMaxCorrection()+1 chunks. Such a code
+ *  matches its marker exactly in one of the chunks, so only the few markers
+ *  sharing one of its chunk values have to be compared.
+ *
+ *  Dictionary files are plain text. The first line holds grid size, number of
+ *  markers and minimum distance, followed by one line per marker with
+ *  nGridSize*nGridSize characters '0' (black) or '1' (white). Lines starting
+ *  with '#' are comments.
+ */
+class MarkerDictionary
+{
+public:
+	MarkerDictionary();
+
+	/// Generates a new dictionary with up to nNumMarkers markers
+	/**
+	 *  Random codes are added as long as they keep nMinDistance to all
+	 *  markers already in the dictionary. Returns the number of markers
+	 *  generated, which might be less than requested if nMinDistance is
+	 *  too large for the grid size. The same seed always creates the same dictionary.
+	 */
+	int generate(int nGridSize, int nNumMarkers, int nMinDistance, unsigned int nSeed=0);
+
+	/// Loads a dictionary file. Returns false on failure.
+	bool load(const char* nFileName);
+
+	/// Writes the dictionary to a file. Returns false on failure.
+	bool save(const char* nFileName) const;
+
+	/// Looks up a grid read from an image
+	/**
+	 *  Returns the marker id or -1 if no marker is close enough. nDir receives
+	 *  the number of 90 degree CW rotations of the grid relative to the marker,
+	 *  nDistance the number of bits that had to be corrected.
+	 */
+	int decode(_64bits nCode, int& nDir, int& nDistance) const;
+
+	/// Returns the code of marker nId (in upright orientation)
+	bool getCode(int nId, _64bits& nCode) const;
+
+	int getGridSize() const  {  return gridSize;  }
+	int getNumMarkers() const  {  return (int)codes.size();  }
+	int getMinDistance() const  {  return minDistance;  }
+
+	/// Returns the number of wrong bits that can be corrected safely
+	int getMaxCorrection() const  {  return (minDistance-1)/2;  }
+
+	/// Returns the number of wrong bits covered by the hash index
+	int getIndexRadius() const  {  return indexRadius;  }
+
+	/// Rotates an nGridSize x nGridSize code by 90 degrees clockwise
+	static _64bits rotate90CW(_64bits nCode, int nGridSize);
+
+	/// Returns the number of bits in which two codes differ
+	static int hammingDistance(_64bits nCode0, _64bits nCode1);
+
+protected:
+	bool addCode(_64bits nCode);
+	int distanceToDictionary(_64bits nCode) const;
+	void buildIndex();
+	void addToIndex(_64bits nCode, int nValue);
+	void addToIndexWithErrors(_64bits nCode, int nValue, int nFirstBit, int nNumErrors);
+	int findInIndex(_64bits nCode) const;
+	void buildChunkIndex();
+	int findInChunkIndex(_64bits nCode) const;
+
+	int gridSize;
+	int minDistance;
+
+	std::vector<_64bits> codes;			// all markers in upright orientation
+	std::vector<_64bits> rotated;		// all markers in all 4 rotations: [id*4+dir]
+
+	std::vector<_64bits> indexKeys;		// open addressing hash table over
+	std::vector<int> indexValues;		// rotated codes: id*4+dir, -1 for empty slots
+	unsigned int indexMask;
+	int indexRadius;					// wrong bits covered by the index
+
+	std::vector<int> chunkLow;			// first bit,
+	std::vector<int> chunkBits;			// number of bits
+	std::vector<int> chunkOffset;		// and first bucket of each chunk
+	std::vector<int> bucketStart;		// rotated codes of bucket b are
+	std::vector<int> bucketEntries;		// bucketEntries[bucketStart[b]..bucketStart[b+1]-1]
+};
+
+
+}  // namespace ARToolKitPlus
+
+
+#endif //__ARTOOLKIT_MARKERDICTIONARY_HEADERFILE__
@@ -0,0 +1,137 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+#ifndef __ARTOOLKITPLUS_POSEFILTER_HEADERFILE__
+#define __ARTOOLKITPLUS_POSEFILTER_HEADERFILE__
+
+
+#include <stddef.h>
+#include <ARToolKitPlus/config.h>
+
+
+namespace ARToolKitPlus {
+
+
+/// PoseFilter smoothes and extrapolates 6-DoF poses of several targets
+/**
+ *  Every target (a marker id or a multi-marker config) is tracked by a
+ *  constant velocity alpha-beta filter: translation and rotation (as a
+ *  quaternion) are predicted to the time of a new measurement, corrected
+ *  by alpha times the residual, and the linear and angular velocities are
+ *  corrected by beta/dt times the residual.
+ *  Times are in seconds. A target that was not updated for longer than
+ *  the maximum gap starts again from its next measurement.
+ *
+ *  Each target can carry a bounding sphere (in target coordinates), which
+ *  is used to predict where the target will show up in the next image.
+ */
+class PoseFilter
+{
+public:
+	PoseFilter();
+
+	/// Sets the filter gains (0 < nAlpha <= 1, 0 <= nBeta < 2)
+	/**
+	 *  Larger values follow the measurements more closely, smaller
+	 *  values smooth more but lag behind fast motion.
+	 */
+	void setGains(ARFloat nAlpha, ARFloat nBeta);
+
+	/// Sets the time (seconds) after which an unobserved target is restarted
+	void setMaxGap(double nMaxGap)  {  maxGap = nMaxGap;  }
+
+	/// Removes all targets
+	void reset();
+
+	/// Removes target nId
+	void remove(int nId);
+
+	/// Feeds the measured pose nTrans of target nId taken at time nTime
+	/**
+	 *  nRadius and nCenter describe the bounding sphere of the target in
+	 *  target coordinates (nCenter==NULL means the origin).
+	 *  If the target table is full the target updated least recently is replaced.
+	 */
+	void update(int nId, double nTime, const ARFloat nTrans[3][4], ARFloat nRadius=0, const ARFloat nCenter[3]=NULL);
+
+	/// Returns the filtered pose of target nId extrapolated to time nTime
+	/**
+	 *  Extrapolation is limited to the maximum gap. Returns false if the
+	 *  target is unknown or was not updated within the maximum gap.
+	 */
+	bool getPose(int nId, double nTime, ARFloat nTrans[3][4]) const;
+
+	/// Returns the bounding sphere of target nId transformed by the pose predicted for nTime
+	bool getSphere(int nId, double nTime, ARFloat nCenter[3], ARFloat* nRadius) const;
+
+	/// Returns the time of the last measurement of target nId or a negative value if unknown
+	double getLastTime(int nId) const;
+
+	int getNumTargets() const  {  return numTargets;  }
+
+	int getTargetId(int nIndex) const  {  return targets[nIndex].id;  }
+
+	double getTargetTime(int nIndex) const  {  return targets[nIndex].time;  }
+
+protected:
+	struct Target {
+		int			id;
+		double		time;
+		ARFloat		pos[3], vel[3];
+		ARFloat		quat[4], angVel[3];		// quat is (w,x,y,z), angVel in rad/s (camera frame)
+		ARFloat		center[3], radius;
+	};
+
+	const Target* findTarget(int nId) const;
+
+	// extrapolates the state of nTarget by nDt seconds
+	static void predict(const Target& nTarget, ARFloat nDt, ARFloat nPos[3], ARFloat nQuat[4]);
+
+	Target		targets[AR_POSE_FILTER_MAX_TARGETS];
+	int			numTargets;
+
+	ARFloat		alpha, beta;
+	double		maxGap;
+};
+
+
+}  // namespace ARToolKitPlus
+
+
+#endif //__ARTOOLKITPLUS_POSEFILTER_HEADERFILE__
@@ -62,6 +62,25 @@ robustPlanarPose(rpp_float &err,
 				 const unsigned int max_iterations);
 
 
+// Same as robustPlanarPose() but without any heap allocation for
+// 4 to 8 points (falls back to robustPlanarPose() otherwise).
+// Returns exactly the same pose as robustPlanarPose().
+void 
+robustPlanarPoseFixed(rpp_float &err,
+				 rpp_mat &R,
+				 rpp_vec &t,
+				 const rpp_float cc[2],
+				 const rpp_float fc[2],
+				 const rpp_vec *model,
+				 const rpp_vec *iprts,
+				 const unsigned int model_iprts_size,
+				 const rpp_mat R_init,
+				 const bool estimate_R_init,
+				 const rpp_float epsilon,
+				 const rpp_float tolerance,
+				 const unsigned int max_iterations);
+
+
 bool rppSupportAvailabe();
 
 
@@ -145,6 +145,61 @@ observ2Ideal(ARFloat ox, ARFloat oy, ARFloat *ix, ARFloat *iy)
 	}
 }
 
+void CameraAdvImpl::
+observ2IdealBatch(int nNum, const ARFloat* nOx, const ARFloat* nOy, ARFloat* nIx, ARFloat* nIy)
+{
+	// same math as observ2Ideal(), but the points are the inner loop so that
+	// the compiler can vectorize it. nIx/nIy hold the normalized estimates.
+	const ARFloat cc0 = cc[0], cc1 = cc[1];
+	const ARFloat fc0 = fc[0], fc1 = fc[1];
+	const ARFloat k1 = kc[0];
+	const ARFloat k2 = kc[1];
+	const ARFloat k3 = kc[4];
+	const ARFloat p1 = kc[2];
+	const ARFloat p2 = kc[3];
+	const int iterations = undist_iterations;
+	int i, kk;
+
+	if(iterations <= 0)
+	{
+		for(i=0; i<nNum; i++)
+		{
+			nIx[i] = nOx[i];
+			nIy[i] = nOy[i];
+		}
+		return;
+	}
+
+	for(i=0; i<nNum; i++)
+	{
+		nIx[i] = (nOx[i] - cc0) / fc0;
+		nIy[i] = (nOy[i] - cc1) / fc1;
+	}
+
+	for(kk=0; kk<iterations; kk++)
+		for(i=0; i<nNum; i++)
+		{
+			const ARFloat xd[2] = { (nOx[i] - cc0) / fc0, (nOy[i] - cc1) / fc1 };
+			const ARFloat x[2] = { nIx[i], nIy[i] };
+			const ARFloat x0_sq = (x[0]*x[0]);
+			const ARFloat x1_sq = (x[1]*x[1]);
+			const ARFloat x0_x1 = (x[0]*x[1]);
+			const ARFloat r_2 = x0_sq + x1_sq;
+			const ARFloat r_2_sq = (r_2 * r_2);
+			const ARFloat k_radial =  1 + k1 * r_2 + k2 * (r_2_sq) + k3 * (r_2*r_2_sq);
+			const ARFloat delta_x[2] = {   2*p1*x0_x1 + p2*(r_2 + 2*x0_sq),
+				p1 * (r_2 + 2*x1_sq) + 2*p2*x0_x1   };
+			nIx[i] = (xd[0] - delta_x[0]) / k_radial;
+			nIy[i] = (xd[1] - delta_x[1]) / k_radial;
+		}
+
+	for(i=0; i<nNum; i++)
+	{
+		nIx[i] = (nIx[i] * fc0) + cc0;
+		nIy[i] = (nIy[i] * fc1) + cc1;
+	}
+}
+
 void CameraAdvImpl::
 ideal2Observ(ARFloat ix, ARFloat iy, ARFloat *ox, ARFloat *oy)
 {
@@ -134,6 +134,44 @@ observ2Ideal(ARFloat ox, ARFloat oy, ARFloat *ix, ARFloat *iy)
 	*iy = py / this->dist_factor[3] + this->dist_factor[1];
 }
 
+void CameraImpl::
+observ2IdealBatch(int nNum, const ARFloat* nOx, const ARFloat* nOy, ARFloat* nIx, ARFloat* nIy)
+{
+	// the iteration of observ2Ideal() without early exit and with the points
+	// as inner loop, which has no branches and can be vectorized by the compiler.
+	// nIx/nIy hold the current estimates relative to the center.
+	const ARFloat cx = this->dist_factor[0], cy = this->dist_factor[1];
+	const ARFloat p = this->dist_factor[2]/(ARFloat)100000000.0;
+	const ARFloat s = this->dist_factor[3];
+	int     i, j;
+
+	for( j = 0; j < nNum; j++ ) {
+		nIx[j] = nOx[j] - cx;
+		nIy[j] = nOy[j] - cy;
+	}
+
+	for( i = 0; i < PD_LOOP; i++ ) {
+		for( j = 0; j < nNum; j++ ) {
+			const ARFloat qx = nOx[j] - cx, qy = nOy[j] - cy;
+			const ARFloat q = (ARFloat)sqrt(qx*qx+ qy*qy);
+			const ARFloat px = nIx[j], py = nIy[j];
+			const ARFloat z02 = px*px+ py*py;
+			const ARFloat z0 = (ARFloat)sqrt(px*px+ py*py);
+
+			// z0 is 0 only for px = py = 0, which stay 0 with any divisor
+			const ARFloat d = (z0 != 0.0) ? z0 : (ARFloat)1.0;
+			const ARFloat z = z0 - (((ARFloat)1.0 - p*z02)*z0 - q) / ((ARFloat)1.0 - (ARFloat)3.0*p*z02);
+			nIx[j] = px * z / d;
+			nIy[j] = py * z / d;
+		}
+	}
+
+	for( j = 0; j < nNum; j++ ) {
+		nIx[j] = nIx[j] / s + cx;
+		nIy[j] = nIy[j] / s + cy;
+	}
+}
+
 void CameraImpl::
 ideal2Observ(ARFloat ix, ARFloat iy, ARFloat *ox, ARFloat *oy)
 {
@@ -50,9 +50,6 @@
 
 namespace ARToolKitPlus {
 
-AR_TEMPL_FUNC int AR_TEMPL_TRACKER::screenWidth;
-AR_TEMPL_FUNC int AR_TEMPL_TRACKER::screenHeight;
-
 AR_TEMPL_FUNC 
 AR_TEMPL_TRACKER::TrackerImpl()
 {
@@ -90,6 +87,7 @@ AR_TEMPL_TRACKER::TrackerImpl()
 		patf[i] = 0;
 	evecf = 0;
 	evecBWf = 0;
+	evecDirty = true;
 
 	// we allocate all large data dynamically
 	//
@@ -97,11 +95,16 @@ AR_TEMPL_TRACKER::TrackerImpl()
 	l_imageL_size = 0;
 
 	workL = artkp_Alloc<int>(WORK_SIZE);
-	work2L = artkp_Alloc<int>(WORK_SIZE*7);
+	work2L = artkp_Alloc<ARLabelSum>(WORK_SIZE*7);
 	wareaL = artkp_Alloc<int>(WORK_SIZE);
 	wclipL = artkp_Alloc<int>(WORK_SIZE*4);
 	wposL = artkp_Alloc<ARFloat>(WORK_SIZE*2);
 
+	arGetLine_ox = artkp_Alloc<ARFloat>(AR_CHAIN_MAX);
+	arGetLine_oy = artkp_Alloc<ARFloat>(AR_CHAIN_MAX);
+	arGetLine_ix = artkp_Alloc<ARFloat>(AR_CHAIN_MAX);
+	arGetLine_iy = artkp_Alloc<ARFloat>(AR_CHAIN_MAX);
+
 	//workL = new int[WORK_SIZE];
 	//work2L = new int[WORK_SIZE*7];
 	//wareaL = new int[WORK_SIZE];
@@ -126,6 +129,8 @@ AR_TEMPL_TRACKER::TrackerImpl()
 	loadCachedUndist        = false;
 	//arParam;
 	arImXsize = arImYsize	= 0;
+	screenWidth = screenHeight = 0;
+	arAreaMax = AR_AREA_MAX;
 	arTemplateMatchingMode  = DEFAULT_TEMPLATE_MATCHING_MODE;
 	arMatchingPCAMode       = DEFAULT_MATCHING_PCA_MODE;
 	arImageL                = NULL;
@@ -137,10 +142,38 @@ AR_TEMPL_TRACKER::TrackerImpl()
 
 	relBorderWidth = 0.25f;
 
+	decodeBeforeFit = false;
+	borderCheck = false;
+
+	idFilterEnabled = false;
+	clearIdFilter();
+
+	idReuse = false;
+	idReuseInterval = 10;
+
+	poseHistoryEnabled = false;
+	poseHistoryFrame = 0;
+	for(i=0; i<MAX_IMAGE_PATTERNS; i++)
+	{
+		poseHistory[i].id = -1;
+		poseHistory[i].frame = 0;
+	}
+
+	searchFilter = &poseFilter;
+	poseFilterEnabled = false;
+	frameTime = prevFrameTime = nextFrameTime = 0.0;
+	nextFrameTimeSet = false;
+
+	predictedSearch = false;
+	predictedSearchCountdown = 0;
+	searchROIActive = false;
+
 	// undistortion addon by Daniel
 	//
 	undistMode = UNDIST_STD;
 	undistO2ITable = NULL;
+	undistSparseTable = NULL;
+	undistSparseXsize = undistSparseYsize = 0;
 	//undistI2OTable = NULL;
 	arParamObserv2Ideal_func = &AR_TEMPL_TRACKER::arParamObserv2Ideal_std;
 	//arParamIdeal2Observ_func = arParamIdeal2Observ_std;
@@ -151,6 +184,7 @@ AR_TEMPL_TRACKER::TrackerImpl()
 	vignetting.bottomtop = 0;
 
 	bchProcessor = NULL;
+	markerDictionary = NULL;
 
 	// RPP integration -- [t.pintaric]
 	poseEstimator = POSE_ESTIMATOR_ORIGINAL;
@@ -174,6 +208,10 @@ AR_TEMPL_TRACKER::~TrackerImpl()
 		delete bchProcessor;
 	bchProcessor = NULL;
 
+	if(markerDictionary)
+		delete markerDictionary;
+	markerDictionary = NULL;
+
 	if(l_imageL)
 		artkp_Free(l_imageL);
 	l_imageL = NULL;
@@ -198,13 +236,27 @@ AR_TEMPL_TRACKER::~TrackerImpl()
 		artkp_Free(wposL);
 	wposL = NULL;
 
+	if(arGetLine_ox)
+		artkp_Free(arGetLine_ox);
+	arGetLine_ox = NULL;
+
+	if(arGetLine_oy)
+		artkp_Free(arGetLine_oy);
+	arGetLine_oy = NULL;
+
+	if(arGetLine_ix)
+		artkp_Free(arGetLine_ix);
+	arGetLine_ix = NULL;
+
+	if(arGetLine_iy)
+		artkp_Free(arGetLine_iy);
+	arGetLine_iy = NULL;
+
 	if(RGB565_to_LUM8_LUT)
 		artkp_Free(RGB565_to_LUM8_LUT);
 	RGB565_to_LUM8_LUT = NULL;
 
-	if(undistO2ITable)
-		artkp_Free(undistO2ITable);
-	undistO2ITable = NULL;
+	freeUndistTables();
 
 	if(descriptionString)
 		delete [] descriptionString;
@@ -263,8 +315,8 @@ AR_TEMPL_TRACKER::checkImageBuffer()
 
 	l_imageL_size = newSize;
 
-	//l_imageL = new ARInt16[newSize];
-	l_imageL = artkp_Alloc<ARInt16>(newSize);
+	//l_imageL = new ARLabel[newSize];
+	l_imageL = artkp_Alloc<ARLabel>(newSize);
 }
 
 
@@ -332,7 +384,12 @@ AR_TEMPL_TRACKER::setCamera(Camera* nCamera)
 		// printf("%f %f %f;\n",arCamera->mat[1][0],arCamera->mat[1][1],arCamera->mat[1][2]);
 		// printf("%f %f %f ]\n",arCamera->mat[2][0],arCamera->mat[2][1],arCamera->mat[2][2]);
 
-		buildUndistO2ITable(arCamera);
+		// the tables of the other modes are built on first use
+		freeUndistTables();
+		if(undistMode==UNDIST_LUT)
+			buildUndistO2ITable(arCamera);
+		else if(undistMode==UNDIST_LUT_SPARSE)
+			buildUndistSparseTable(arCamera);
 	}
 }
 
@@ -448,7 +505,7 @@ AR_TEMPL_TRACKER::calcCameraMatrix(const char* nCamParamFile, int nWidth, int nH
 		return(false);
 	}
 
-	pCam->changeFrameSize(AR_TEMPL_TRACKER::screenWidth,AR_TEMPL_TRACKER::screenHeight);
+	pCam->changeFrameSize(nWidth,nHeight);
 
 	int i;
     for(i = 0; i < 4; i++ )
@@ -456,7 +513,9 @@ AR_TEMPL_TRACKER::calcCameraMatrix(const char* nCamParamFile, int nWidth, int nH
 
 	ARFloat glcpara[16];
 
-    if(!convertProjectionMatrixToOpenGLStyle((ARParam*)pCam, nNear,nFar, glcpara))
+    bool ok = convertProjectionMatrixToOpenGLStyle((ARParam*)pCam, nNear,nFar, glcpara);
+	delete pCam;
+	if(!ok)
 		return false;
 
 	// convert to float (in case of ARFloat is def'ed to doubled
@@ -501,6 +560,10 @@ AR_TEMPL_TRACKER::setUndistortionMode(UNDIST_MODE nMode)
 		arParamObserv2Ideal_func = &AR_TEMPL_TRACKER::arParamObserv2Ideal_LUT;
 		//arParamIdeal2Observ_func = arParamIdeal2Observ_LUT;
 		break;
+
+	case UNDIST_LUT_SPARSE:
+		arParamObserv2Ideal_func = &AR_TEMPL_TRACKER::arParamObserv2Ideal_LUTSparse;
+		break;
 	}
 }
 
@@ -540,31 +603,346 @@ AR_TEMPL_TRACKER::setPoseEstimator(POSE_ESTIMATOR nMode)
 }
 
 
+AR_TEMPL_FUNC ARFloat (*
+AR_TEMPL_TRACKER::findPoseHistory(int nId, ARFloat *nErr))[4]
+{
+	if(nErr)
+		*nErr = -1.0f;
+
+	if(nId<0)
+		return NULL;
+
+	for(int i=0; i<MAX_IMAGE_PATTERNS; i++)
+		if(poseHistory[i].id==nId)
+		{
+			if(poseHistoryFrame-poseHistory[i].frame > AR_POSE_HISTORY_MAX_AGE)
+				return NULL;
+			if(nErr)
+				*nErr = poseHistory[i].err;
+			return poseHistory[i].trans;
+		}
+
+	return NULL;
+}
+
+
+AR_TEMPL_FUNC void
+AR_TEMPL_TRACKER::storePoseHistory(int nId, ARFloat conv[3][4], ARFloat err)
+{
+	int i, j, slot = 0;
+
+	if(nId<0 || err<0.0f)
+		return;
+
+	// reuse the entry of this id or else the oldest one
+	for(i=0; i<MAX_IMAGE_PATTERNS; i++)
+	{
+		if(poseHistory[i].id==nId)
+		{
+			slot = i;
+			break;
+		}
+		if(poseHistory[i].id<0 || poseHistory[i].frame<poseHistory[slot].frame)
+			slot = i;
+	}
+
+	poseHistory[slot].id = nId;
+	poseHistory[slot].frame = poseHistoryFrame;
+	poseHistory[slot].err = err;
+	for(j=0; j<3; j++)
+		for(i=0; i<4; i++)
+			poseHistory[slot].trans[j][i] = conv[j][i];
+}
+
+
+AR_TEMPL_FUNC void
+AR_TEMPL_TRACKER::activatePoseFilter(bool nEnable, ARFloat nAlpha, ARFloat nBeta)
+{
+	poseFilterEnabled = nEnable;
+	poseFilter.setGains(nAlpha, nBeta);
+	if(!nEnable)
+		poseFilter.reset();
+}
+
+
+AR_TEMPL_FUNC void
+AR_TEMPL_TRACKER::updatePoseFilter(int nId, ARFloat center[2], ARFloat width, ARFloat conv[3][4], ARFloat err)
+{
+	if(nId<0 || err<0.0f)
+		return;
+
+	// bounding sphere of the marker square
+	ARFloat sphereCenter[3] = { center[0], center[1], 0 };
+	poseFilter.update(nId, frameTime, conv, width*(ARFloat)0.70711, sphereCenter);
+}
+
+
+AR_TEMPL_FUNC bool
+AR_TEMPL_TRACKER::getPredictedBox(const PoseFilter& nFilter, int nId, double nTime, int nBox[4])
+{
+	ARFloat c[3], radius, ix, iy, ox, oy, h, r;
+
+	if(!arCamera || !nFilter.getSphere(nId, nTime, c, &radius))
+		return false;
+
+	// the sphere must be completely in front of the camera
+	if(c[2] <= radius)
+		return false;
+
+	ARFloat (*mat)[4] = arCamera->mat;
+	h  = mat[2][0]*c[0] + mat[2][1]*c[1] + mat[2][2]*c[2] + mat[2][3];
+	ix = (mat[0][0]*c[0] + mat[0][1]*c[1] + mat[0][2]*c[2] + mat[0][3]) / h;
+	iy = (mat[1][0]*c[0] + mat[1][1]*c[1] + mat[1][2]*c[2] + mat[1][3]) / h;
+	arCamera->ideal2Observ(ix, iy, &ox, &oy);
+
+	// radius as seen at the nearest point of the sphere
+	r = (mat[0][0]>mat[1][1] ? mat[0][0] : mat[1][1]) * radius / (c[2]-radius);
+	r = r*(ARFloat)(1.0+AR_PREDICTED_SEARCH_REL_MARGIN) + AR_PREDICTED_SEARCH_MARGIN;
+
+	nBox[0] = (int)floor(ox-r);
+	nBox[1] = (int)floor(oy-r);
+	nBox[2] = (int)ceil(ox+r);
+	nBox[3] = (int)ceil(oy+r);
+
+	if(nBox[0]<0)  nBox[0] = 0;
+	if(nBox[1]<0)  nBox[1] = 0;
+	if(nBox[2]>arImXsize-1)  nBox[2] = arImXsize-1;
+	if(nBox[3]>arImYsize-1)  nBox[3] = arImYsize-1;
+
+	return nBox[0]<nBox[2] && nBox[1]<nBox[3];
+}
+
+
+AR_TEMPL_FUNC void
+AR_TEMPL_TRACKER::beginFrame()
+{
+	int i, box[4];
+
+	prevFrameTime = frameTime;
+	frameTime = nextFrameTimeSet ? nextFrameTime : frameTime + 1.0/AR_POSE_FILTER_DEFAULT_FPS;
+	nextFrameTimeSet = false;
+
+	searchROIActive = false;
+
+	if(!predictedSearch || !poseFilterEnabled || !searchFilter)
+		return;
+
+	if(--predictedSearchCountdown < 0)
+	{
+		predictedSearchCountdown = AR_PREDICTED_SEARCH_FULL_INTERVAL-1;
+		return;
+	}
+
+	// search around everything that was seen in the previous image
+	for(i=0; i<searchFilter->getNumTargets(); i++)
+	{
+		if(searchFilter->getTargetTime(i) < prevFrameTime)
+			continue;
+
+		// can't tell where this one is: fall back to the full image
+		if(!getPredictedBox(*searchFilter, searchFilter->getTargetId(i), frameTime, box))
+		{
+			searchROIActive = false;
+			return;
+		}
+
+		if(!searchROIActive)
+		{
+			searchROI[0] = box[0];  searchROI[1] = box[1];
+			searchROI[2] = box[2];  searchROI[3] = box[3];
+			searchROIActive = true;
+			continue;
+		}
+
+		if(box[0]<searchROI[0])  searchROI[0] = box[0];
+		if(box[1]<searchROI[1])  searchROI[1] = box[1];
+		if(box[2]>searchROI[2])  searchROI[2] = box[2];
+		if(box[3]>searchROI[3])  searchROI[3] = box[3];
+	}
+}
+
+
 AR_TEMPL_FUNC ARFloat
-AR_TEMPL_TRACKER::executeSingleMarkerPoseEstimator(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4])
+AR_TEMPL_TRACKER::estimateSingleMarkerPose(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat prev_err, ARFloat center[2], ARFloat width, ARFloat conv[3][4])
 {
 	switch(poseEstimator)
 	{
 	case POSE_ESTIMATOR_ORIGINAL:
-		return arGetTransMat(marker_info, center, width, conv);
-
 	case POSE_ESTIMATOR_ORIGINAL_CONT:
-		return arGetTransMatCont2(marker_info, center, width, conv);
+		if(prev_conv)
+			return arGetTransMatCont(marker_info, prev_conv, center, width, conv);
+		return arGetTransMat(marker_info, center, width, conv);
 
 	case POSE_ESTIMATOR_RPP:
 		if(rppSupportAvailabe())
 		{
+			if(prev_conv)
+				return rppGetTransMatCont(marker_info, prev_conv, center, width, conv);
 			return rppGetTransMat(marker_info, center, width, conv);
 		}
 		if(logger)
 			logger->artLog("ARToolKitPlus: Failed to set RPP pose estimator - RPP disabled during build\n");
 		return -1.0f;
+
+	case POSE_ESTIMATOR_LM:
+		if(prev_conv)
+			return lmGetTransMatCont(marker_info, prev_conv, center, width, conv);
+		return lmGetTransMat(marker_info, center, width, conv);
+
+	case POSE_ESTIMATOR_AUTO:
+		return estimateSingleMarkerPoseAuto(marker_info, prev_conv, prev_err, center, width, conv);
 	}
 
 	return -1.0f;
 }
 
 
+AR_TEMPL_FUNC ARFloat
+AR_TEMPL_TRACKER::estimateSingleMarkerPoseAuto(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat prev_err, ARFloat center[2], ARFloat width, ARFloat conv[3][4])
+{
+	ARFloat err, rppErr, rppConv[3][4];
+	int i, j;
+
+	// the cheap estimator always runs, well-conditioned markers that fit stop here
+	err = prev_conv ? arGetTransMatCont(marker_info, prev_conv, center, width, conv)
+					: arGetTransMat(marker_info, center, width, conv);
+
+	// RPP does not find a pose for small markers, so they keep the cheap one
+	if(!rppSupportAvailabe() || marker_info->area < AR_POSE_AUTO_MIN_AREA)
+		return err;
+
+	if(err >= 0.0f && err <= AR_POSE_AUTO_MAX_FIT_ERROR && !isMarkerPoseAmbiguous(marker_info, prev_err))
+		return err;
+
+	rppErr = prev_conv ? rppGetTransMatCont(marker_info, prev_conv, center, width, rppConv)
+					   : rppGetTransMat(marker_info, center, width, rppConv);
+
+	// RPP reports an object space error, so both poses are compared in the image
+	if(rppErr >= 0.0f)
+		rppErr = getMarkerFitError(marker_info, center, width, rppConv);
+
+	if(rppErr < 0.0f || (err >= 0.0f && err <= rppErr))
+		return err;
+
+	for(j=0; j<3; j++)
+		for(i=0; i<4; i++)
+			conv[j][i] = rppConv[j][i];
+
+	return rppErr;
+}
+
+
+AR_TEMPL_FUNC bool
+AR_TEMPL_TRACKER::isMarkerPoseAmbiguous(ARMarkerInfo *marker_info, ARFloat prev_err)
+{
+	ARFloat len[4], dx, dy;
+	int i;
+
+	if(prev_err > AR_POSE_AUTO_MAX_FIT_ERROR)
+		return true;
+
+	for(i=0; i<4; i++)
+	{
+		dx = marker_info->vertex[(i+1)%4][0] - marker_info->vertex[i][0];
+		dy = marker_info->vertex[(i+1)%4][1] - marker_info->vertex[i][1];
+		len[i] = (ARFloat)sqrt(dx*dx + dy*dy);
+	}
+
+	// under (nearly) affine projection opposite edges keep their length,
+	// and that is where the two pose solutions of a square are hard to tell apart
+	return (ARFloat)fabs(len[0]-len[2]) < AR_POSE_AUTO_MIN_PERSPECTIVE*(len[0]+len[2]) &&
+		   (ARFloat)fabs(len[1]-len[3]) < AR_POSE_AUTO_MIN_PERSPECTIVE*(len[1]+len[3]);
+}
+
+
+AR_TEMPL_FUNC ARFloat
+AR_TEMPL_TRACKER::getMarkerFitError(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4])
+{
+	const ARFloat w2 = width*(ARFloat)0.5;
+	const ARFloat cx[4] = { center[0]-w2, center[0]+w2, center[0]+w2, center[0]-w2 };
+	const ARFloat cy[4] = { center[1]+w2, center[1]+w2, center[1]-w2, center[1]-w2 };
+	ARFloat err = 0, x, y, z, hx, hy, h;
+	int k, v, dir = marker_info->dir;
+
+	for(k=0; k<4; k++)
+	{
+		x = conv[0][0]*cx[k] + conv[0][1]*cy[k] + conv[0][3];
+		y = conv[1][0]*cx[k] + conv[1][1]*cy[k] + conv[1][3];
+		z = conv[2][0]*cx[k] + conv[2][1]*cy[k] + conv[2][3];
+
+		hx = arCamera->mat[0][0]*x + arCamera->mat[0][1]*y + arCamera->mat[0][2]*z + arCamera->mat[0][3];
+		hy = arCamera->mat[1][0]*x + arCamera->mat[1][1]*y + arCamera->mat[1][2]*z + arCamera->mat[1][3];
+		h  = arCamera->mat[2][0]*x + arCamera->mat[2][1]*y + arCamera->mat[2][2]*z + arCamera->mat[2][3];
+		if(h <= 0.0f)
+			return -1.0f;
+
+		v = (4-dir+k)%4;
+		hx = hx/h - marker_info->vertex[v][0];
+		hy = hy/h - marker_info->vertex[v][1];
+		err += hx*hx + hy*hy;
+	}
+
+	return err/4;
+}
+
+
+AR_TEMPL_FUNC ARFloat
+AR_TEMPL_TRACKER::executeSingleMarkerPoseEstimator(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4])
+{
+	const bool history = usePoseHistory();
+
+	ARFloat prev_err = -1.0f, (*prev_conv)[4] = history ? findPoseHistory(marker_info->id, &prev_err) : NULL;
+	ARFloat err = estimateSingleMarkerPose(marker_info, prev_conv, prev_err, center, width, conv);
+
+	if(history)
+		storePoseHistory(marker_info->id, conv, err);
+	if(poseFilterEnabled)
+		updatePoseFilter(marker_info->id, center, width, conv, err);
+
+	return err;
+}
+
+
+AR_TEMPL_FUNC int
+AR_TEMPL_TRACKER::executeSingleMarkerPoseEstimatorBatch(ARMarkerInfo *marker_info, int marker_num, ARFloat center[2], ARFloat width, ARFloat conv[][3][4], ARFloat err[])
+{
+	int i, num_found = 0;
+	const bool history = usePoseHistory();
+
+	if(poseEstimator==POSE_ESTIMATOR_RPP && !rppSupportAvailabe())
+	{
+		if(logger)
+			logger->artLog("ARToolKitPlus: Failed to set RPP pose estimator - RPP disabled during build\n");
+		for(i=0; i<marker_num; i++)
+			err[i] = -1.0f;
+		return 0;
+	}
+
+	// every marker only touches its own conv[i] and err[i] and only reads the
+	// pose history. the profiler is not thread safe, so don't go parallel while profiling.
+#if defined(_OPENMP) && !defined(_USE_PROFILING_)
+	#pragma omp parallel for if(marker_num>=AR_BATCH_POSE_MIN_PARALLEL) schedule(dynamic) reduction(+:num_found)
+#endif
+	for(i=0; i<marker_num; i++)
+	{
+		ARFloat prev_err = -1.0f, (*prev_conv)[4] = history ? findPoseHistory(marker_info[i].id, &prev_err) : NULL;
+		err[i] = estimateSingleMarkerPose(&marker_info[i], prev_conv, prev_err, center, width, conv[i]);
+		if(err[i] >= 0.0f)
+			num_found++;
+	}
+
+	if(history)
+		for(i=0; i<marker_num; i++)
+			storePoseHistory(marker_info[i].id, conv[i], err[i]);
+
+	if(poseFilterEnabled)
+		for(i=0; i<marker_num; i++)
+			updatePoseFilter(marker_info[i].id, center, width, conv[i], err[i]);
+
+	return num_found;
+}
+
+
 AR_TEMPL_FUNC ARFloat
 AR_TEMPL_TRACKER::executeMultiMarkerPoseEstimator(ARMarkerInfo *marker_info, int marker_num, ARMultiMarkerInfoT *config)
 {
@@ -584,6 +962,12 @@ AR_TEMPL_TRACKER::executeMultiMarkerPoseEstimator(ARMarkerInfo *marker_info, int
 		if(logger)
 			logger->artLog("ARToolKitPlus: Failed to set RPP pose estimator - RPP disabled during build\n");
 		return -1.0f;
+
+	case POSE_ESTIMATOR_LM:
+		return lmMultiGetTransMat(marker_info, marker_num, config);
+
+	case POSE_ESTIMATOR_AUTO:
+		return arMultiGetTransMat(marker_info, marker_num, config);
 	}
 
 	return -1.0f;
@@ -608,6 +992,97 @@ AR_TEMPL_TRACKER::setMarkerMode(MARKER_MODE nMarkerMode)
 }
 
 
+AR_TEMPL_FUNC bool
+AR_TEMPL_TRACKER::setIdFilterEntry(int nId, bool nAllowed)
+{
+	if(nId<0 || nId>=AR_ID_FILTER_MAX)
+		return false;
+
+	if(nAllowed)
+		idFilter[nId>>5] |= (1u<<(nId&31));
+	else
+		idFilter[nId>>5] &= ~(1u<<(nId&31));
+
+	return true;
+}
+
+
+AR_TEMPL_FUNC void
+AR_TEMPL_TRACKER::clearIdFilter()
+{
+	memset(idFilter, 0, sizeof(idFilter));
+}
+
+
+AR_TEMPL_FUNC int
+AR_TEMPL_TRACKER::generateMarkerDictionary(int nGridSize, int nNumMarkers, int nMinDistance)
+{
+	// the pattern is downsampled to the grid, so it must be a multiple of it
+	if(nGridSize<1 || PATTERN_WIDTH%nGridSize!=0 || PATTERN_HEIGHT%nGridSize!=0)
+	{
+		if(logger)
+			logger->artLogEx("ARToolKitPlus: Dictionary grid size %d does not divide the %dx%d pattern size",
+							 nGridSize, PATTERN_WIDTH, PATTERN_HEIGHT);
+		return 0;
+	}
+
+	if(markerDictionary==NULL)
+		markerDictionary = new MarkerDictionary;
+
+	int num = markerDictionary->generate(nGridSize, nNumMarkers, nMinDistance);
+
+	if(num<nNumMarkers && logger)
+		logger->artLogEx("ARToolKitPlus: Generated only %d of %d dictionary markers with minimum distance %d",
+						 num, nNumMarkers, nMinDistance);
+
+	return num;
+}
+
+
+AR_TEMPL_FUNC bool
+AR_TEMPL_TRACKER::loadMarkerDictionary(const char* nFileName)
+{
+	// the current dictionary stays in use if the file can not be used
+	//
+	MarkerDictionary* dict = new MarkerDictionary;
+
+	if(!dict->load(nFileName))
+	{
+		if(logger)
+			logger->artLogEx("ARToolKitPlus: Failed to load marker dictionary '%s'", nFileName);
+		delete dict;
+		return false;
+	}
+
+	const int gridSize = dict->getGridSize();
+
+	if(PATTERN_WIDTH%gridSize!=0 || PATTERN_HEIGHT%gridSize!=0)
+	{
+		if(logger)
+			logger->artLogEx("ARToolKitPlus: Dictionary grid size %d of '%s' does not divide the %dx%d pattern size",
+							 gridSize, nFileName, PATTERN_WIDTH, PATTERN_HEIGHT);
+		delete dict;
+		return false;
+	}
+
+	if(markerDictionary)
+		delete markerDictionary;
+	markerDictionary = dict;
+
+	return true;
+}
+
+
+AR_TEMPL_FUNC bool
+AR_TEMPL_TRACKER::saveMarkerDictionary(const char* nFileName)
+{
+	if(markerDictionary==NULL || markerDictionary->getNumMarkers()==0)
+		return false;
+
+	return markerDictionary->save(nFileName);
+}
+
+
 static void
 convertPixel16To24(unsigned short nPixel, unsigned char& nRed, unsigned char& nGreen, unsigned char& nBlue)
 {
@@ -778,10 +1253,11 @@ AR_TEMPL_TRACKER::getDynamicMemoryRequirements()
 	// requirements for allocations in the constructor
 	//
 	size_t size = sizeof(unsigned int)*(WORK_SIZE +			// workL = new int[WORK_SIZE];
-										WORK_SIZE*7 +		// work2L = new int[WORK_SIZE*7];
 										WORK_SIZE +			// wareaL = new int[WORK_SIZE];
 										WORK_SIZE*4 +		// wclipL = new int[WORK_SIZE*4];
 										WORK_SIZE*2);		// wposL = new ARFloat[WORK_SIZE*2];
+	size += sizeof(ARLabelSum)*WORK_SIZE*7;					// work2L = new ARLabelSum[WORK_SIZE*7];
+	size += sizeof(ARFloat)*AR_CHAIN_MAX*4;					// arGetLine_ox/oy/ix/iy = new ARFloat[AR_CHAIN_MAX];
 
 	// requirements for the image buffer (arImageL)
 	//
@@ -795,12 +1271,12 @@ AR_TEMPL_TRACKER::getDynamicMemoryRequirements()
 
 	// requirements for allocation of l_imageL
 	//
-	size += sizeof(ARInt16)*MAX_BUFFER_WIDTH*MAX_BUFFER_HEIGHT;
+	size += sizeof(ARLabel)*MAX_BUFFER_WIDTH*MAX_BUFFER_HEIGHT;
 
 
 	// requirements for the lens undistortion table (undistO2ITable)
 	//
-	size += sizeof(unsigned int)*MAX_BUFFER_WIDTH*MAX_BUFFER_HEIGHT;
+	size += sizeof(ARUndistEntry)*MAX_BUFFER_WIDTH*MAX_BUFFER_HEIGHT;
 
 
 	// requirements for the RGB565 to gray table RGB565_to_LUM8_LUT
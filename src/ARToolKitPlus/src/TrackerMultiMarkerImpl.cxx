@@ -59,6 +59,9 @@ ARMM_TEMPL_TRACKER::TrackerMultiMarkerImpl(int nWidth, int nHeight)
 	numDetected = 0;
 
 	config = 0;
+	numConfigs = 0;
+
+	this->searchFilter = &configFilter;
 
 	this->thresh = 150;
 }
@@ -68,8 +71,18 @@ ARMM_TEMPL_FUNC
 ARMM_TEMPL_TRACKER::~TrackerMultiMarkerImpl()
 {
 	cleanup();
-	if(config)
-		arMultiFreeConfig(config);
+	freeConfigs();
+}
+
+
+ARMM_TEMPL_FUNC void
+ARMM_TEMPL_TRACKER::freeConfigs()
+{
+	for(int i=0; i<numConfigs; i++)
+		arMultiFreeConfig(configs[i]);
+	numConfigs = 0;
+	config = 0;
+	configFilter.reset();
 }
 
 
@@ -87,16 +100,64 @@ ARMM_TEMPL_TRACKER::init(const char* nCamParamFile, const char* nMultiFile, ARFl
 	if(!loadCameraFile(nCamParamFile, nNearClip, nFarClip))
 		return false;
 
-	if(config)
-		arMultiFreeConfig(config);
+	freeConfigs();
 
-    if((config = arMultiReadConfigFile(nMultiFile)) == NULL )
+    if(addMultiMarkerConfig(nMultiFile) < 0)
         return false;
 
+    return true;
+}
+
+
+ARMM_TEMPL_FUNC int
+ARMM_TEMPL_TRACKER::addMultiMarkerConfig(const char* nMultiFile)
+{
+	if(numConfigs>=AR_MULTI_MAX_CONFIGS)
+	{
+		if(this->logger)
+			this->logger->artLogEx("ARToolKitPlus: can not load more than %d multi-marker configs", AR_MULTI_MAX_CONFIGS);
+		return -1;
+	}
+
+	ARMultiMarkerInfoT *newConfig = arMultiReadConfigFile(nMultiFile);
+	if(newConfig == NULL)
+		return -1;
+
+	configs[numConfigs] = newConfig;
+	configErr[numConfigs] = -1.0f;
+	config = configs[0];
+
 	if(this->logger)
-		this->logger->artLogEx("INFO: %d markers loaded from config file", config->marker_num);
+		this->logger->artLogEx("INFO: %d markers loaded from config file", newConfig->marker_num);
 
-    return true;
+	return numConfigs++;
+}
+
+
+ARMM_TEMPL_FUNC bool
+ARMM_TEMPL_TRACKER::replaceMultiMarkerConfig(int nConfig, const char* nMultiFile)
+{
+	if(nConfig<0 || nConfig>=numConfigs)
+		return false;
+
+	ARMultiMarkerInfoT *newConfig = arMultiReadConfigFile(nMultiFile);
+	if(newConfig == NULL)
+	{
+		if(this->logger)
+			this->logger->artLogEx("ARToolKitPlus: failed to load multi-marker config '%s'", nMultiFile);
+		return false;
+	}
+
+	arMultiFreeConfig(configs[nConfig]);
+	configs[nConfig] = newConfig;
+	configErr[nConfig] = -1.0f;
+	configFilter.remove(nConfig);
+	config = configs[0];
+
+	if(this->logger)
+		this->logger->artLogEx("INFO: %d markers loaded from config file", newConfig->marker_num);
+
+	return true;
 }
 
 
@@ -127,14 +188,90 @@ ARMM_TEMPL_TRACKER::calc(const unsigned char* nImage)
 				break;
 		}
 
-	if(executeMultiMarkerPoseEstimator(tmp_markers, tmpNumDetected, config) < 0)
+	if(numConfigs==0)
 		return 0;
 
-	this->convertTransformationMatrixToOpenGLStyle(config->trans, this->gl_para);
+	// the first config works directly on the detector's markers,
+	// all others on a copy (see configMarkers)
+	for(int c=1; c<numConfigs; c++)
+		memcpy(configMarkers[c-1], tmp_markers, tmpNumDetected*sizeof(ARMarkerInfo));
+
+	// every config only touches its own buffers. storing the pose history and
+	// updating the marker pose filter are not thread safe and neither is the
+	// profiler, so stay serial in these cases.
+	int c, numTracked = 0;
+
+#if defined(_OPENMP) && !defined(_USE_PROFILING_)
+	const bool parallel = numConfigs>1 && !this->usePoseHistory() && !this->poseFilterEnabled;
+	#pragma omp parallel for if(parallel) schedule(dynamic) reduction(+:numTracked)
+#endif
+	for(c=0; c<numConfigs; c++)
+	{
+		configErr[c] = executeMultiMarkerPoseEstimator(c==0 ? tmp_markers : configMarkers[c-1], tmpNumDetected, configs[c]);
+		if(configErr[c] >= 0.0f)
+		{
+			this->convertTransformationMatrixToOpenGLStyle(configs[c]->trans, configGLPara[c]);
+			numTracked++;
+		}
+	}
+
+	if(this->poseFilterEnabled)
+		for(c=0; c<numConfigs; c++)
+			if(configErr[c] >= 0.0f)
+				updateConfigFilter(c);
+
+	if(numTracked==0)
+		return 0;
+
+	if(configErr[0] >= 0.0f)
+		memcpy(this->gl_para, configGLPara[0], sizeof(configGLPara[0]));
+
 	return numDetected;
 }
 
 
+ARMM_TEMPL_FUNC void
+ARMM_TEMPL_TRACKER::activatePoseFilter(bool nEnable, ARFloat nAlpha, ARFloat nBeta)
+{
+	AR_TEMPL_TRACKER::activatePoseFilter(nEnable, nAlpha, nBeta);
+	configFilter.setGains(nAlpha, nBeta);
+	if(!nEnable)
+		configFilter.reset();
+}
+
+
+ARMM_TEMPL_FUNC void
+ARMM_TEMPL_TRACKER::updateConfigFilter(int nConfig)
+{
+	const ARMultiMarkerInfoT *cfg = configs[nConfig];
+	ARFloat center[3] = { 0, 0, 0 }, radius = 0, d;
+	int i, j, k;
+
+	if(cfg->marker_num<=0)
+		return;
+
+	// bounding sphere around the corners of all markers
+	for(i=0; i<cfg->marker_num; i++)
+		for(j=0; j<4; j++)
+			for(k=0; k<3; k++)
+				center[k] += cfg->marker[i].pos3d[j][k];
+	for(k=0; k<3; k++)
+		center[k] /= cfg->marker_num*4;
+
+	for(i=0; i<cfg->marker_num; i++)
+		for(j=0; j<4; j++)
+		{
+			d = 0;
+			for(k=0; k<3; k++)
+				d += (cfg->marker[i].pos3d[j][k]-center[k]) * (cfg->marker[i].pos3d[j][k]-center[k]);
+			if(d>radius)
+				radius = d;
+		}
+
+	configFilter.update(nConfig, this->frameTime, cfg->trans, (ARFloat)sqrt(radius), center);
+}
+
+
 ARMM_TEMPL_FUNC void
 ARMM_TEMPL_TRACKER::getDetectedMarkers(int*& nMarkerIDs)
 {
@@ -151,6 +288,18 @@ ARMM_TEMPL_TRACKER::getARMatrix(ARFloat nMatrix[3][4]) const
 }
 
 
+ARMM_TEMPL_FUNC void
+ARMM_TEMPL_TRACKER::getARMatrix(int nConfig, ARFloat nMatrix[3][4]) const
+{
+	if(nConfig<0 || nConfig>=numConfigs)
+		return;
+
+	for(int i=0; i<3; i++)
+		for(int j=0; j<4; j++)
+			nMatrix[i][j] = configs[nConfig]->trans[i][j];
+}
+
+
 
 ARMM_TEMPL_FUNC void*
 ARMM_TEMPL_TRACKER::operator new(size_t size)
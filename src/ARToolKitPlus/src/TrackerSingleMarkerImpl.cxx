@@ -208,6 +208,21 @@ ARSM_TEMPL_TRACKER::addPattern(const char* nFileName)
 }
 
 
+ARSM_TEMPL_FUNC int
+ARSM_TEMPL_TRACKER::addPatternBundle(const char* nFileName)
+{
+	int patt_id = arLoadPattBundle(nFileName);
+
+    if(patt_id<0)
+	{
+		if(this->logger)
+			this->logger->artLogEx("ARToolKitPlus: error loading pattern bundle '%s'", nFileName);
+	}
+
+	return patt_id;
+}
+
+
 ARSM_TEMPL_FUNC void
 ARSM_TEMPL_TRACKER::getARMatrix(ARFloat nMatrix[3][4]) const
 {
@@ -221,126 +221,96 @@ checkPatternBCH(IDPATTERN nPattern, int& nID, float& nProp, BCH* nProcessor)
 }
 
 
-AR_TEMPL_FUNC int
-AR_TEMPL_TRACKER::downsamplePattern(ARUint8* data, unsigned char* imgPtr)
+// helpers for downsamplePattern(): sum up the luminance of a
+// CELL_X x CELL_Y cell of an RGB24 pattern image. the recursion
+// is resolved at compile time, resulting in the same straight
+// code as a hand unrolled loop for any cell size.
+//
+template <int CELL_X>
+struct PatternCellRow
 {
-	int x,y;
-
-	if(PATTERN_WIDTH==18 && PATTERN_HEIGHT==18)
+	static inline int sum(const ARUint8* data)
 	{
-		// this code simply takes the center pixel of each 3x3 cell
-		// this is the fastest method for 18x18 to convert down to 6x6 but gives worst results
-		// even more: this method gives no advantage over directly using a pattern size of 6x6.
-		//
-/*
-		for(y=1; y<PATTERN_HEIGHT; y+=3)
-			for(x=1; x<PATTERN_WIDTH; x+=3)
-			{
-				int idx = (y*PATTERN_WIDTH+x)*3;
-				*imgPtr++ = (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
-			}
-*/
-
-		// this code downsamples the 18x18 RGB24 image to 6x6 LUM8 by
-		// averaging each 3x3 cell into a single pixel
-		//
-		for(y=0; y<PATTERN_HEIGHT; y+=3)
-			for(x=0; x<PATTERN_WIDTH; x+=3)
-			{
-				int idx = (y*PATTERN_WIDTH+x)*3, val=0;
-				val = (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
-
-				idx += 3;
-				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
-
-				idx += 3;
-				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
-
-				idx += PATTERN_WIDTH*3 - 6;
-				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
-
-				idx += 3;
-				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+		const ARUint8* pix = data + (CELL_X-1)*3;
+		return PatternCellRow<CELL_X-1>::sum(data) + ((pix[0]+(pix[1]<<1)+pix[2])>>2);
+	}
+};
 
-				idx += 3;
-				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+template <>
+struct PatternCellRow<0>
+{
+	static inline int sum(const ARUint8*)  {  return 0;  }
+};
 
-				idx += PATTERN_WIDTH*3 - 6;
-				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+template <int CELL_X, int CELL_Y, int ROW_STRIDE>
+struct PatternCell
+{
+	static inline int sum(const ARUint8* data)
+	{
+		return PatternCell<CELL_X, CELL_Y-1, ROW_STRIDE>::sum(data) +
+			   PatternCellRow<CELL_X>::sum(data + (CELL_Y-1)*ROW_STRIDE);
+	}
+};
 
-				idx += 3;
-				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+template <int CELL_X, int ROW_STRIDE>
+struct PatternCell<CELL_X, 0, ROW_STRIDE>
+{
+	static inline int sum(const ARUint8*)  {  return 0;  }
+};
 
-				idx += 3;
-				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
 
-				*imgPtr++ = val/9;
-			}
+// downsamples a PATT_W x PATT_H RGB24 pattern image into a LUM8 grid
+// by averaging each CELL_X x CELL_Y cell into a single pixel
+//
+template <int PATT_W, int PATT_H, int CELL_X, int CELL_Y>
+static void
+downsampleCells(const ARUint8* data, unsigned char* imgPtr)
+{
+	enum {
+		GRID_W = PATT_W/CELL_X,
+		GRID_H = PATT_H/CELL_Y,
+		CELL_SIZE = CELL_X*CELL_Y
+	};
 
-/*
-		FILE* fp = fopen("dump18x18.raw", "wb");
-		fwrite(data, PATTERN_HEIGHT*PATTERN_WIDTH*3, 1, fp);
-		fclose(fp);
+	int x, y;
 
-		fp = fopen("dump6x6.raw", "wb");
-		fwrite(patimg, 6*6, 1, fp);
-		fclose(fp);
-*/
-	}
-	else
-	if(PATTERN_WIDTH==12 && PATTERN_HEIGHT==12)
-	{
-		// this code downsamples the 12x12 RGB24 image to 6x6 LUM8 by
-		// averaging each 2x2 cell into a single pixel
-		//
-		for(y=0; y<PATTERN_HEIGHT; y+=2)
-			for(x=0; x<PATTERN_WIDTH; x+=2)
-			{
-				int idx = (y*PATTERN_WIDTH+x)*3, val=0;
-				val = (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+	for(y=0; y<GRID_H; y++, data+=CELL_Y*PATT_W*3)
+		for(x=0; x<GRID_W; x++)
+			*imgPtr++ = (unsigned char)(PatternCell<CELL_X, CELL_Y, PATT_W*3>::sum(data + x*CELL_X*3) / CELL_SIZE);
+}
 
-				idx += 3;
-				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
 
-				idx += PATTERN_WIDTH*3 - 3;
-				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+// downsamples a PATT_W x PATT_H RGB24 pattern image to a GRID_W x GRID_H
+// LUM8 grid. returns -1 if the pattern is not a multiple of the grid.
+//
+template <int PATT_W, int PATT_H, int GRID_W, int GRID_H>
+static int
+downsampleToGrid(const ARUint8* data, unsigned char* imgPtr)
+{
+	// the cell size is fixed by the template parameters. it is clamped
+	// to 1 for patterns smaller than the grid, which are rejected below.
+	//
+	enum {
+		CELL_X = PATT_W>=GRID_W ? PATT_W/GRID_W : 1,
+		CELL_Y = PATT_H>=GRID_H ? PATT_H/GRID_H : 1
+	};
 
-				idx += 3;
-				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+	if(PATT_W!=CELL_X*GRID_W || PATT_H!=CELL_Y*GRID_H)
+		return -1;
 
-				*imgPtr++ = val/4;
-			}
+	downsampleCells<PATT_W, PATT_H, CELL_X, CELL_Y>(data, imgPtr);
 
-/*
-		FILE* fp = fopen("dump12x12.raw", "wb");
-		fwrite(data, PATTERN_HEIGHT*PATTERN_WIDTH*3, 1, fp);
-		fclose(fp);
+	return 0;
+}
 
-		fp = fopen("dump6x6.raw", "wb");
-		fwrite(patimg, 6*6, 1, fp);
-		fclose(fp);
-*/
-	}
-	else
-	if(PATTERN_WIDTH==6 && PATTERN_HEIGHT==6)
-	{
-		// this code simply converts the 6x6 RGB pattern into a
-		// 6x6 greyscale image
-		//
-		for(int idx=0; idx<PATTERN_WIDTH*PATTERN_HEIGHT*3; idx+=3)
-			*imgPtr++ = (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
 
-/*
-	FILE* fp = fopen("dump6x6.raw", "wb");
-	fwrite(data, PATTERN_HEIGHT*PATTERN_WIDTH, 1, fp);
-	fclose(fp);
-*/
-	}
-	else
+AR_TEMPL_FUNC int
+AR_TEMPL_TRACKER::downsamplePattern(ARUint8* data, unsigned char* imgPtr)
+{
+	if(downsampleToGrid<PATTERN_WIDTH, PATTERN_HEIGHT, idPattWidth, idPattHeight>(data, imgPtr)==-1)
 	{
-		// the pattern size has to be 18x18, 12x12 or 6x6
-		// for performance reasons generic downsampling is not supported
-		assert((PATTERN_WIDTH==18 && PATTERN_HEIGHT==18) || (PATTERN_WIDTH==12 && PATTERN_HEIGHT==12) || (PATTERN_WIDTH==6 && PATTERN_HEIGHT==6));
+		// the pattern size has to be a multiple of the 6x6 id grid (6x6, 12x12, 18x18, 24x24, ...)
+		assert(PATTERN_WIDTH%idPattWidth==0 && PATTERN_HEIGHT%idPattHeight==0);
 		return -1;
 	}
 
@@ -357,11 +327,8 @@ AR_TEMPL_TRACKER::bitfield_check_simple( ARUint8 *data, int *code, int *dir, ARF
 	unsigned char patimg[idPattWidth*idPattHeight], *imgPtr=patimg;
 	int i;
 
-	// first step is to reduce the pattern to 6x6. only the following
-	// three resolutions are supported:
-	//   - 18x18 (downsampling of each 3x3 cell)
-	//   - 12x12 (downsampling of each 2x2 cell)
-	//   -  6x6  (no downsampling)
+	// first step is to reduce the pattern to 6x6. the pattern size
+	// has to be a multiple of 6x6 (e.g. 18x18 averages each 3x3 cell)
 	//
 	if(downsamplePattern(data, imgPtr)==-1)
 	{
@@ -448,11 +415,8 @@ AR_TEMPL_TRACKER::bitfield_check_BCH( ARUint8 *data, int *code, int *dir, ARFloa
 	int i;
 
 
-	// first step is to reduce the pattern to 6x6. only the following
-	// three resolutions are supported:
-	//   - 18x18 (downsampling of each 3x3 cell)
-	//   - 12x12 (downsampling of each 2x2 cell)
-	//   -  6x6  (no downsampling)
+	// first step is to reduce the pattern to 6x6. the pattern size
+	// has to be a multiple of 6x6 (e.g. 18x18 averages each 3x3 cell)
 	//
 	if(downsamplePattern(data, imgPtr)==-1)
 	{
@@ -533,5 +497,67 @@ AR_TEMPL_TRACKER::bitfield_check_BCH( ARUint8 *data, int *code, int *dir, ARFloa
 }
 
 
+AR_TEMPL_FUNC int
+AR_TEMPL_TRACKER::bitfield_check_dictionary( ARUint8 *data, int *code, int *dir, ARFloat *cf, int thresh)
+{
+	unsigned char patimg[DICTIONARY_MAX_GRID*DICTIONARY_MAX_GRID];
+	int i, res = -1;
+
+	*code = -1;
+	*dir = 0;
+	*cf = -1.0f;
+
+	if(markerDictionary==NULL || markerDictionary->getNumMarkers()==0)
+		return -1;
+
+
+	// first step is to reduce the pattern to the dictionary's grid.
+	// the pattern size has to be a multiple of the grid size.
+	//
+	const int gridSize = markerDictionary->getGridSize();
+
+	switch(gridSize)
+	{
+	case 4:
+		res = downsampleToGrid<PATTERN_WIDTH, PATTERN_HEIGHT, 4, 4>(data, patimg);
+		break;
+
+	case 5:
+		res = downsampleToGrid<PATTERN_WIDTH, PATTERN_HEIGHT, 5, 5>(data, patimg);
+		break;
+
+	case 6:
+		res = downsampleToGrid<PATTERN_WIDTH, PATTERN_HEIGHT, 6, 6>(data, patimg);
+		break;
+	}
+
+	if(res==-1)
+		return -1;
+
+
+	// threshold the grid (first cell goes to the most significant bit)
+	// and look it up. the index already contains all rotations.
+	//
+	_64bits pat = 0;
+	int distance;
+
+	for(i=0; i<gridSize*gridSize; i++)
+		pat = (pat<<1) | (patimg[i]>thresh ? 1 : 0);
+
+	*code = markerDictionary->decode(pat, *dir, distance);
+
+	if(*code<0)
+		*cf = 0.0f;
+	else
+	{
+		// every correctable distance has to stay above AR_MIN_CONFIDENCE,
+		// otherwise the detector would drop the corrected ids again.
+		*cf = 1.0f - 0.5f * (ARFloat)distance / (ARFloat)(markerDictionary->getMaxCorrection()+1);
+	}
+
+	return 0;
+}
+
+
 
 }  // namespace ARToolKitPlus
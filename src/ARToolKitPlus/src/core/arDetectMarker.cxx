@@ -50,7 +50,7 @@ namespace ARToolKitPlus {
 AR_TEMPL_FUNC int
 AR_TEMPL_TRACKER::arDetectMarker(ARUint8 *dataPtr, int _thresh, ARMarkerInfo **marker_info, int *marker_num)
 {
-    ARInt16                *limage=NULL;
+    ARLabel                *limage=NULL;
     int                    label_num;
     int                    *area, *clip, *label_ref;
     ARFloat                 *pos;
@@ -62,6 +62,9 @@ AR_TEMPL_TRACKER::arDetectMarker(ARUint8 *dataPtr, int _thresh, ARMarkerInfo **m
 	autoThreshold.reset();
 	checkImageBuffer();
 
+	poseHistoryFrame++;
+	beginFrame();
+
 //	FILE* fp = fopen("imgdump.raw", "wb");
 //	fwrite(dataPtr, 1, 320*240*2, fp);
 //	fclose(fp);
@@ -73,17 +76,24 @@ AR_TEMPL_TRACKER::arDetectMarker(ARUint8 *dataPtr, int _thresh, ARMarkerInfo **m
 		limage = arLabeling(dataPtr, _thresh, &label_num, &area, &pos, &clip, &label_ref);
 		if(limage)
 		{
-			marker_info2 = arDetectMarker2(limage, label_num, label_ref, area, pos, clip, AR_AREA_MAX, AR_AREA_MIN, 1.0, &wmarker_num);
+			marker_info2 = arDetectMarker2(limage, label_num, label_ref, area, pos, clip, arAreaMax, AR_AREA_MIN, 1.0, &wmarker_num);
 			assert(wmarker_num <= MAX_IMAGE_PATTERNS);
 			if(marker_info2)
 			{
-				wmarker_info = arGetMarkerInfo(dataPtr, marker_info2, &wmarker_num, _thresh);
+				wmarker_info = arGetMarkerInfo(dataPtr, marker_info2, &wmarker_num, _thresh, true);
 				assert(wmarker_num <= MAX_IMAGE_PATTERNS);
 				if(wmarker_info && wmarker_num>0)
 					break;
 			}
 		}
 
+		// nothing in the predicted search region: try the full image before touching the threshold
+		if(searchROIActive)
+		{
+			searchROIActive = false;
+			continue;
+		}
+
 		if(!autoThreshold.enable)
 			break;
 		else
@@ -136,7 +146,7 @@ AR_TEMPL_TRACKER::arDetectMarker(ARUint8 *dataPtr, int _thresh, ARMarkerInfo **m
     }
 
     for( i = 0; i < wmarker_num; i++ ) {
-        if( wmarker_info[i].cf < 0.5 ) wmarker_info[i].id = -1;
+        if( wmarker_info[i].cf < AR_MIN_CONFIDENCE ) wmarker_info[i].id = -1;
    }
 
 
@@ -163,6 +173,7 @@ AR_TEMPL_TRACKER::arDetectMarker(ARUint8 *dataPtr, int _thresh, ARMarkerInfo **m
 		{
 			prev_info[j].marker = wmarker_info[i];
 			prev_info[j].count  = 1;
+			prev_info[j].reuse  = marker_reuseL[i];
 			if( j == prev_num )
 				prev_num++;
 		}
@@ -203,7 +214,7 @@ AR_TEMPL_TRACKER::arDetectMarker(ARUint8 *dataPtr, int _thresh, ARMarkerInfo **m
 AR_TEMPL_FUNC int
 AR_TEMPL_TRACKER::arDetectMarkerLite(ARUint8 *dataPtr, int _thresh, ARMarkerInfo **marker_info, int *marker_num)
 {
-    ARInt16                *limage = NULL;
+    ARLabel                *limage = NULL;
     int                    label_num;
     int                    *area, *clip, *label_ref;
     ARFloat                 *pos;
@@ -212,6 +223,9 @@ AR_TEMPL_TRACKER::arDetectMarkerLite(ARUint8 *dataPtr, int _thresh, ARMarkerInfo
 	autoThreshold.reset();
 	checkImageBuffer();
 
+	poseHistoryFrame++;
+	beginFrame();
+
     *marker_num = 0;
 
 	for(int numTries = 0;;)
@@ -219,7 +233,7 @@ AR_TEMPL_TRACKER::arDetectMarkerLite(ARUint8 *dataPtr, int _thresh, ARMarkerInfo
 		limage = arLabeling(dataPtr, _thresh, &label_num, &area, &pos, &clip, &label_ref);
 		if(limage)
 		{
-			marker_info2 = arDetectMarker2(limage, label_num, label_ref, area, pos, clip, AR_AREA_MAX, AR_AREA_MIN, 1.0, &wmarker_num);
+			marker_info2 = arDetectMarker2(limage, label_num, label_ref, area, pos, clip, arAreaMax, AR_AREA_MIN, 1.0, &wmarker_num);
 			if(marker_info2)
 			{
 				wmarker_info = arGetMarkerInfo(dataPtr, marker_info2, &wmarker_num, _thresh);
@@ -228,6 +242,13 @@ AR_TEMPL_TRACKER::arDetectMarkerLite(ARUint8 *dataPtr, int _thresh, ARMarkerInfo
 			}
 		}
 
+		// nothing in the predicted search region: try the full image before touching the threshold
+		if(searchROIActive)
+		{
+			searchROIActive = false;
+			continue;
+		}
+
 		if(!autoThreshold.enable)
 			break;
 		else
@@ -247,7 +268,7 @@ AR_TEMPL_TRACKER::arDetectMarkerLite(ARUint8 *dataPtr, int _thresh, ARMarkerInfo
     limage = arLabeling(dataPtr, _thresh, &label_num, &area, &pos, &clip, &label_ref);
     if( limage == 0 )    return -1;
 
-    marker_info2 = arDetectMarker2(limage, label_num, label_ref, area, pos, clip, AR_AREA_MAX, AR_AREA_MIN, 1.0, &wmarker_num);
+    marker_info2 = arDetectMarker2(limage, label_num, label_ref, area, pos, clip, arAreaMax, AR_AREA_MIN, 1.0, &wmarker_num);
     if( marker_info2 == 0 ) return -1;
 
     wmarker_info = arGetMarkerInfo(dataPtr, marker_info2, &wmarker_num, _thresh);
@@ -255,7 +276,7 @@ AR_TEMPL_TRACKER::arDetectMarkerLite(ARUint8 *dataPtr, int _thresh, ARMarkerInfo
 */
 
     for( i = 0; i < wmarker_num; i++ )
-        if( wmarker_info[i].cf < 0.5 )
+        if( wmarker_info[i].cf < AR_MIN_CONFIDENCE )
 			wmarker_info[i].id = -1;
 
 
@@ -48,12 +48,11 @@ static int get_vertex( int x_coord[], int y_coord[], int st,  int ed,
 
 
 AR_TEMPL_FUNC ARMarkerInfo2*
-AR_TEMPL_TRACKER::arDetectMarker2(ARInt16 *limage, int label_num, int *label_ref,
+AR_TEMPL_TRACKER::arDetectMarker2(ARLabel *limage, int label_num, int *label_ref,
                     int *warea, ARFloat *wpos, int *wclip,
                     int area_max, int area_min, ARFloat factor, int *marker_num)
 {
     ARMarkerInfo2     *pm;
-    int               xsize, ysize;
     int               marker_num2;
     int               i, j, ret;
     ARFloat            d;
@@ -63,18 +62,13 @@ AR_TEMPL_TRACKER::arDetectMarker2(ARInt16 *limage, int label_num, int *label_ref
     if( arImageProcMode == AR_IMAGE_PROC_IN_HALF ) {
         area_min /= 4;
         area_max /= 4;
-        xsize = arImXsize / 2;
-        ysize = arImYsize / 2;
-    }
-    else {
-        xsize = arImXsize;
-        ysize = arImYsize;
     }
     marker_num2 = 0;
+    // labels touching the border of the labeled area (see arLabeling()) are cut off
     for(i=0; i<label_num; i++ ) {
         if( warea[i] < area_min || warea[i] > area_max ) continue;
-        if( wclip[i*4+0] == 1 || wclip[i*4+1] == xsize-2 ) continue;
-        if( wclip[i*4+2] == 1 || wclip[i*4+3] == ysize-2 ) continue;
+        if( wclip[i*4+0] <= labelROI[0] || wclip[i*4+1] >= labelROI[1] ) continue;
+        if( wclip[i*4+2] <= labelROI[2] || wclip[i*4+3] >= labelROI[3] ) continue;
 
         ret = arGetContour( limage, label_ref, i+1,
                             &(wclip[i*4]), &(marker_infoTWO[marker_num2]));
@@ -140,13 +134,13 @@ AR_TEMPL_TRACKER::arDetectMarker2(ARInt16 *limage, int label_num, int *label_ref
 
 
 AR_TEMPL_FUNC int
-AR_TEMPL_TRACKER::arGetContour(ARInt16 *limage, int *label_ref, int label, int clip[4], ARMarkerInfo2 *marker_infoTWO)
+AR_TEMPL_TRACKER::arGetContour(ARLabel *limage, int *label_ref, int label, int clip[4], ARMarkerInfo2 *marker_infoTWO)
 {
     static const int      xdir[8] = { 0, 1, 1, 1, 0,-1,-1,-1};
     static const int      ydir[8] = {-1,-1, 0, 1, 1, 1, 0,-1};
     //static int      wx[AR_CHAIN_MAX];
     //static int      wy[AR_CHAIN_MAX];
-    ARInt16         *p1;
+    ARLabel         *p1;
     int             xsize, ysize;
     int             sx, sy, dir;
     int             dmax, d, v1 = 0;
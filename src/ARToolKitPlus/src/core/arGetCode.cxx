@@ -120,9 +120,8 @@ AR_TEMPL_TRACKER::arLoadPatt(char *filename)
     patf[patno] = 1;
     pattern_num++;
 
-/*
-    gen_evec();
-*/
+    // the eigen-basis is rebuilt lazily once the library is complete
+    evecDirty = true;
 
     return( patno );
 }
@@ -135,7 +134,7 @@ AR_TEMPL_TRACKER::arFreePatt( int patno )
     patf[patno] = 0;
     pattern_num--;
 
-    gen_evec();
+    evecDirty = true;
 
     return 1;
 }
@@ -163,11 +162,11 @@ AR_TEMPL_TRACKER::arDeactivatePatt( int patno )
 
 AR_TEMPL_FUNC int
 AR_TEMPL_TRACKER::arGetCode(ARUint8 *image, int *x_coord, int *y_coord, int *vertex,
-				   int *code, int *dir, ARFloat *cf, int thresh)
+				   int *code, int *dir, ARFloat *cf, int thresh, const ARFloat (*nPara)[3])
 {
     ARUint8 ext_pat[PATTERN_HEIGHT][PATTERN_WIDTH][3];
 
-    arGetPatt(image, x_coord, y_coord, vertex, ext_pat);
+    arGetPatt(image, x_coord, y_coord, vertex, ext_pat, nPara);
 
 	if(autoThreshold.enable)
 	{
@@ -198,6 +197,10 @@ AR_TEMPL_TRACKER::arGetCode(ARUint8 *image, int *x_coord, int *y_coord, int *ver
 	case MARKER_ID_BCH:
 		bitfield_check_BCH((ARUint8 *)ext_pat, code, dir, cf, thresh);
 		break;
+
+	case MARKER_ID_DICTIONARY:
+		bitfield_check_dictionary((ARUint8 *)ext_pat, code, dir, cf, thresh);
+		break;
 	}
 
 	/*if(useBitFieldMarkers)
@@ -213,15 +216,105 @@ AR_TEMPL_TRACKER::arGetCode(ARUint8 *image, int *x_coord, int *y_coord, int *ver
     return(0);
 }
 
+
+// samples a sparse ring of points in the middle of the marker border.
+// returns -1 if more than AR_BORDER_CHECK_MAX_BRIGHT samples are
+// brighter than the threshold, 0 otherwise.
+//
+AR_TEMPL_FUNC int
+AR_TEMPL_TRACKER::arCheckBorder(ARUint8 *image, int *x_coord, int *y_coord, int *vertex, int thresh, ARFloat para[3][3])
+{
+    ARFloat    world[4][2];
+    ARFloat    local[4][2];
+    ARFloat    d, xw, yw;
+    int        xc, yc, col;
+    int        i, j, k, bright;
+
+	unsigned short* image16 = (unsigned short*)image;
+
+    world[0][0] = 100.0;
+    world[0][1] = 100.0;
+    world[1][0] = 100.0 + 10.0;
+    world[1][1] = 100.0;
+    world[2][0] = 100.0 + 10.0;
+    world[2][1] = 100.0 + 10.0;
+    world[3][0] = 100.0;
+    world[3][1] = 100.0 + 10.0;
+    for( i = 0; i < 4; i++ ) {
+        local[i][0] = (ARFloat)x_coord[vertex[i]];
+        local[i][1] = (ARFloat)y_coord[vertex[i]];
+    }
+    get_cpara( world, local, para );
+
+	// the ring runs through the middle of the border band. each side
+	// is walked from one ring corner towards the next one.
+	//
+	ARFloat ringFrom = 100.0f + relBorderWidth * 5.0f,
+			ringTo = 110.0f - relBorderWidth * 5.0f;
+	ARFloat ring[4][2] = { { ringFrom, ringFrom }, { ringTo, ringFrom },
+						   { ringTo, ringTo }, { ringFrom, ringTo } };
+
+	bright = 0;
+	for( k = 0; k < 4; k++ ) {
+		ARFloat dx = (ring[(k+1)&3][0] - ring[k][0]) / (ARFloat)AR_BORDER_CHECK_SAMPLES;
+		ARFloat dy = (ring[(k+1)&3][1] - ring[k][1]) / (ARFloat)AR_BORDER_CHECK_SAMPLES;
+
+		for( j = 0; j < AR_BORDER_CHECK_SAMPLES; j++ ) {
+			xw = ring[k][0] + dx * ((ARFloat)j+0.5f);
+			yw = ring[k][1] + dy * ((ARFloat)j+0.5f);
+			d = para[2][0]*xw + para[2][1]*yw + para[2][2];
+			if( d == 0 ) return(-1);
+			xc = (int)((para[0][0]*xw + para[0][1]*yw + para[0][2])/d);
+			yc = (int)((para[1][0]*xw + para[1][1]*yw + para[1][2])/d);
+
+			// samples outside the image are not held against the candidate
+			if( xc < 0 || xc >= arImXsize || yc < 0 || yc >= arImYsize )
+				continue;
+
+			switch(pixelFormat)
+			{
+			case PIXEL_FORMAT_ABGR:
+				col = image[(yc*arImXsize+xc)*4+1] + image[(yc*arImXsize+xc)*4+2] + image[(yc*arImXsize+xc)*4+3];
+				break;
+
+			case PIXEL_FORMAT_BGRA:
+			case PIXEL_FORMAT_RGBA:
+				col = image[(yc*arImXsize+xc)*4+0] + image[(yc*arImXsize+xc)*4+1] + image[(yc*arImXsize+xc)*4+2];
+				break;
+
+			case PIXEL_FORMAT_BGR:
+			case PIXEL_FORMAT_RGB:
+				col = image[(yc*arImXsize+xc)*3+0] + image[(yc*arImXsize+xc)*3+1] + image[(yc*arImXsize+xc)*3+2];
+				break;
+
+			case PIXEL_FORMAT_RGB565:
+				col = 3*getLUM8_from_RGB565(image16+yc*arImXsize+xc);
+				break;
+
+			case PIXEL_FORMAT_LUM:
+			default:
+				col = 3*image[yc*arImXsize+xc];
+				break;
+			}
+
+			if( col > thresh*3 && ++bright > AR_BORDER_CHECK_MAX_BRIGHT )
+				return(-1);
+		}
+	}
+
+    return(0);
+}
+
+
 //#if 1
 AR_TEMPL_FUNC int
 AR_TEMPL_TRACKER::arGetPatt(ARUint8 *image, int *x_coord, int *y_coord, int *vertex,
-						    ARUint8 ext_pat[PATTERN_HEIGHT][PATTERN_WIDTH][3])
+						    ARUint8 ext_pat[PATTERN_HEIGHT][PATTERN_WIDTH][3], const ARFloat (*nPara)[3])
 {
     ARUint32  ext_pat2[PATTERN_HEIGHT][PATTERN_WIDTH][3];
     ARFloat    world[4][2];
     ARFloat    local[4][2];
-    ARFloat    para[3][3];
+    ARFloat    paraBuf[3][3];
     ARFloat    d, xw, yw;
     int       xc, yc;
     int       xdiv, ydiv;
@@ -245,7 +338,13 @@ AR_TEMPL_TRACKER::arGetPatt(ARUint8 *image, int *x_coord, int *y_coord, int *ver
         local[i][0] = (ARFloat)x_coord[vertex[i]];
         local[i][1] = (ARFloat)y_coord[vertex[i]];
     }
-    get_cpara( world, local, para );
+
+    // reuse the homography if arCheckBorder() already solved it for this quad
+    const ARFloat (*para)[3] = nPara;
+    if( para == NULL ) {
+        get_cpara( world, local, paraBuf );
+        para = paraBuf;
+    }
 
     lx1 = (int)((local[0][0] - local[1][0])*(local[0][0] - local[1][0])
               + (local[0][1] - local[1][1])*(local[0][1] - local[1][1]));
@@ -656,6 +755,11 @@ AR_TEMPL_TRACKER::pattern_match( ARUint8 *data, int *code, int *dir, ARFloat *cf
         return -1;
     }
 
+    if( arMatchingPCAMode == AR_MATCHING_WITH_PCA && evecDirty ) {
+        gen_evec();
+        evecDirty = false;
+    }
+
     res = res2 = -1;
     if( arTemplateMatchingMode == AR_TEMPLATE_MATCHING_COLOR ) {
         if( arMatchingPCAMode == AR_MATCHING_WITH_PCA && evecf ) {
@@ -691,9 +795,11 @@ AR_TEMPL_TRACKER::pattern_match( ARUint8 *data, int *code, int *dir, ARFloat *cf
                 printf("\n");
 #endif
             }
-            sum = 0;
-            for(i=0;i<PATTERN_HEIGHT*PATTERN_WIDTH*3;i++) sum += input[i]*pat[res2][res][i];
-            max = sum / patpow[res2][res] / datapow;
+            if( res2 >= 0 ) {
+                sum = 0;
+                for(i=0;i<PATTERN_HEIGHT*PATTERN_WIDTH*3;i++) sum += input[i]*pat[res2][res][i];
+                max = sum / patpow[res2][res] / datapow;
+            }
         }
         else {
             k = -1;
@@ -765,7 +871,7 @@ AR_TEMPL_TRACKER::gen_evec(void)
         if( patf[jj] == 0 ) continue;
         for( k = 0; k < 4; k++ ) {
             for( i = 0; i < PATTERN_HEIGHT*PATTERN_WIDTH*3; i++ ) {
-                input->m[(j*4+k)*PATTERN_HEIGHT*PATTERN_WIDTH*3+i] = pat[j][k][i] / patpow[j][k];
+                input->m[(j*4+k)*PATTERN_HEIGHT*PATTERN_WIDTH*3+i] = pat[jj][k][i] / patpow[jj][k];
             }
         }
         j++;
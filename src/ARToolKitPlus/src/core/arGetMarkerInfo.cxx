@@ -44,12 +44,62 @@
 namespace ARToolKitPlus {
 
 
+// checks if a candidate with the given area and center continues
+// a marker from the tracking history (same test as in arDetectMarker)
+//
+AR_TEMPL_FUNC bool
+AR_TEMPL_TRACKER::continuesTrack(const arPrevInfo& nTrack, int nArea, const ARFloat nPos[2]) const
+{
+    ARFloat         rarea, rlen;
+
+    rarea = (ARFloat)nTrack.marker.area / (ARFloat)nArea;
+    if( rarea < 0.7 || rarea > 1.43 ) return false;
+
+    rlen = ( (nPos[0] - nTrack.marker.pos[0]) * (nPos[0] - nTrack.marker.pos[0])
+           + (nPos[1] - nTrack.marker.pos[1]) * (nPos[1] - nTrack.marker.pos[1]) ) / nArea;
+
+    return rlen < 0.5;
+}
+
+
+// returns the tracking history entry whose id candidate nCandidate may
+// inherit without decoding, or -1 if the candidate has to be decoded.
+// the match has to be unique in both directions.
+//
+AR_TEMPL_FUNC int
+AR_TEMPL_TRACKER::findReusableTrack(ARMarkerInfo2 *marker_info2, int marker_num, int nCandidate) const
+{
+    int            i, k, track = -1;
+
+    for( k = 0; k < prev_num; k++ ) {
+        if( prev_info[k].count != 1 || prev_info[k].marker.cf < AR_MIN_CONFIDENCE ) continue;
+        if( !continuesTrack(prev_info[k], marker_info2[nCandidate].area, marker_info2[nCandidate].pos) ) continue;
+        if( track >= 0 ) return -1;
+        track = k;
+    }
+
+    if( track < 0 || prev_info[track].reuse >= idReuseInterval ) return -1;
+
+    for( i = 0; i < marker_num; i++ ) {
+        if( i != nCandidate && continuesTrack(prev_info[track], marker_info2[i].area, marker_info2[i].pos) ) return -1;
+    }
+
+    return track;
+}
+
+
 AR_TEMPL_FUNC ARMarkerInfo*
-AR_TEMPL_TRACKER::arGetMarkerInfo(ARUint8 *image, ARMarkerInfo2 *marker_info2, int *marker_num, int thresh)
+AR_TEMPL_TRACKER::arGetMarkerInfo(ARUint8 *image, ARMarkerInfo2 *marker_info2, int *marker_num, int thresh, bool nUseHistory)
 {
     int            id, dir;
     ARFloat         cf;
-    int            i, j;
+    ARFloat         diff, diffmin;
+    int            i, j, k, s, reuse;
+    ARFloat        para[3][3];
+    const ARFloat  (*quadPara)[3];
+
+    // the id filter needs the id before the line fit, too
+    const bool     decodeFirst = decodeBeforeFit || idFilterEnabled;
 
 	PROFILE_BEGINSEC(profiler, GETMARKERINFO)
 
@@ -58,17 +108,77 @@ AR_TEMPL_TRACKER::arGetMarkerInfo(ARUint8 *image, ARMarkerInfo2 *marker_info2, i
         marker_infoL[j].pos[0] = marker_info2[i].pos[0];
         marker_infoL[j].pos[1] = marker_info2[i].pos[1];
 
+        // the border check solves the quad homography, arGetCode reuses it
+        quadPara = NULL;
+        if( borderCheck ) {
+            if( arCheckBorder(image, marker_info2[i].x_coord, marker_info2[i].y_coord,
+                              marker_info2[i].vertex, thresh, para) < 0 ) continue;
+            quadPara = para;
+        }
+
+        // a candidate that continues a confidently decoded marker takes over
+        // its id. the rotation follows from the best matching corner order.
+        //
+        reuse = ( nUseHistory && idReuse ) ? findReusableTrack(marker_info2, *marker_num, i) : -1;
+
+        if( reuse >= 0 ) {
+            id = prev_info[reuse].marker.id;
+            // the id filter may have changed since the id was decoded
+            if( idFilterEnabled && !isIdAllowed(id) ) continue;
+            cf = prev_info[reuse].marker.cf;
+            diffmin = 10000.0 * 10000.0;
+            dir = prev_info[reuse].marker.dir;
+            for( s = 0; s < 4; s++ ) {
+                diff = 0;
+                for( k = 0; k < 4; k++ ) {
+                    int v = marker_info2[i].vertex[(s+k)%4];
+                    diff += (prev_info[reuse].marker.vertex[k][0] - marker_info2[i].x_coord[v])
+                          * (prev_info[reuse].marker.vertex[k][0] - marker_info2[i].x_coord[v])
+                          + (prev_info[reuse].marker.vertex[k][1] - marker_info2[i].y_coord[v])
+                          * (prev_info[reuse].marker.vertex[k][1] - marker_info2[i].y_coord[v]);
+                }
+                if( diff < diffmin ) {
+                    diffmin = diff;
+                    dir = (prev_info[reuse].marker.dir - s + 4) % 4;
+                }
+            }
+        }
+        else if( decodeFirst ) {
+            // arGetCode samples the marker via the integer contour vertices only,
+            // so decoding before the line fit samples exactly the same image.
+            // filtered ids and (with decode-before-fit) candidates that fail to decode
+            // skip the expensive arGetLine. the latter are kept if they might continue
+            // a tracked marker whose id arDetectMarker can recover.
+            //
+            arGetCode( image,
+                       marker_info2[i].x_coord, marker_info2[i].y_coord,
+                       marker_info2[i].vertex, &id, &dir, &cf, thresh, quadPara);
+
+            if( cf >= AR_MIN_CONFIDENCE ) {
+                if( idFilterEnabled && !isIdAllowed(id) ) continue;
+            }
+            else if( decodeBeforeFit ) {
+                if( !nUseHistory ) continue;
+                for( k = 0; k < prev_num; k++ ) {
+                    if( continuesTrack(prev_info[k], marker_info2[i].area, marker_info2[i].pos) ) break;
+                }
+                if( k == prev_num ) continue;
+            }
+        }
+
         if( arGetLine(marker_info2[i].x_coord, marker_info2[i].y_coord,
                       marker_info2[i].coord_num, marker_info2[i].vertex,
                       marker_infoL[j].line, marker_infoL[j].vertex) < 0 ) continue;
 
-        arGetCode( image,
-                   marker_info2[i].x_coord, marker_info2[i].y_coord,
-                   marker_info2[i].vertex, &id, &dir, &cf, thresh);
+        if( !decodeFirst && reuse < 0 )
+            arGetCode( image,
+                       marker_info2[i].x_coord, marker_info2[i].y_coord,
+                       marker_info2[i].vertex, &id, &dir, &cf, thresh, quadPara);
 
         marker_infoL[j].id  = id;
         marker_infoL[j].dir = dir;
         marker_infoL[j].cf  = cf;
+        marker_reuseL[j]    = reuse >= 0 ? prev_info[reuse].reuse + 1 : 0;
 
         j++;
     }
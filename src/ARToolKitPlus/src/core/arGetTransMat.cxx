@@ -54,18 +54,14 @@ AR_TEMPL_TRACKER::arGetTransMat(ARMarkerInfo *marker_info, ARFloat center[2], AR
     ARFloat  rot[3][3];
     ARFloat  ppos2d[4][2];
     ARFloat  ppos3d[4][2];
+    ARFloat  irot[2][3][3], itrans[2][3], ierr[2];
+    ARFloat  wconv[3][4], werr;
     int     dir;
     ARFloat  err;
-    int     i;
+    int     i, j, k, s, nsol;
 
 	PROFILE_BEGINSEC(profiler, GETTRANSMAT)
 
-	if( arGetInitRot( marker_info, arCamera->mat, rot ) < 0 )
-	{
-		PROFILE_ENDSEC(profiler, GETTRANSMAT)
-		return -1;
-	}
-
     dir = marker_info->dir;
     ppos2d[0][0] = marker_info->vertex[(4-dir)%4][0];
     ppos2d[0][1] = marker_info->vertex[(4-dir)%4][1];
@@ -84,10 +80,50 @@ AR_TEMPL_TRACKER::arGetTransMat(ARMarkerInfo *marker_info, ARFloat center[2], AR
     ppos3d[3][0] = center[0] - width*(ARFloat)0.5;
     ppos3d[3][1] = center[1] - width*(ARFloat)0.5;
 
-    for( i = 0; i < AR_GET_TRANS_MAT_MAX_LOOP_COUNT; i++ ) {
-		err = arGetTransMat3( rot, ppos2d, ppos3d, 4, conv, arCamera);
-        if( err < AR_GET_TRANS_MAT_MAX_FIT_ERROR ) break;
-    }
+	// closed form initial pose. if it already fits, there is nothing to refine
+	nsol = arGetInitPoseIPPE( ppos2d, width, arCamera->mat, irot, itrans, ierr );
+	if( nsol > 0 && ierr[0] < AR_GET_TRANS_MAT_IPPE_MAX_FIT_ERROR ) {
+		for( j = 0; j < 3; j++ ) {
+			for( i = 0; i < 3; i++ ) conv[j][i] = irot[0][j][i];
+			conv[j][3] = itrans[0][j] - irot[0][j][0]*center[0] - irot[0][j][1]*center[1];
+		}
+		PROFILE_ENDSEC(profiler, GETTRANSMAT)
+		return ierr[0];
+	}
+
+	if( nsol <= 0 ) {
+		if( arGetInitRot( marker_info, arCamera->mat, rot ) < 0 )
+		{
+			PROFILE_ENDSEC(profiler, GETTRANSMAT)
+			return -1;
+		}
+		for( i = 0; i < AR_GET_TRANS_MAT_MAX_LOOP_COUNT; i++ ) {
+			err = arGetTransMat3( rot, ppos2d, ppos3d, 4, conv, arCamera);
+			if( err < AR_GET_TRANS_MAT_MAX_FIT_ERROR ) break;
+		}
+		PROFILE_ENDSEC(profiler, GETTRANSMAT)
+		return err;
+	}
+
+	// refine starting from the closed form rotations. the second (ambiguous) one
+	// is only tried if the refined first one still fits worse than it
+	err = -1;
+	for( s = 0; s < nsol; s++ ) {
+		if( s > 0 && ierr[s] >= err ) break;
+
+		for( j = 0; j < 3; j++ )
+			for( k = 0; k < 3; k++ ) rot[j][k] = irot[s][j][k];
+		for( i = 0; i < AR_GET_TRANS_MAT_MAX_LOOP_COUNT; i++ ) {
+			werr = arGetTransMat3( rot, ppos2d, ppos3d, 4, wconv, arCamera);
+			if( werr < AR_GET_TRANS_MAT_MAX_FIT_ERROR ) break;
+		}
+
+		if( err < 0 || werr < err ) {
+			for( j = 0; j < 3; j++ )
+				for( k = 0; k < 4; k++ ) conv[j][k] = wconv[j][k];
+			err = werr;
+		}
+	}
 
 	PROFILE_ENDSEC(profiler, GETTRANSMAT)
     return err;
@@ -106,6 +142,7 @@ AR_TEMPL_TRACKER::arGetTransMat3(ARFloat rot[3][3], ARFloat ppos2d[][2],
 				   Camera *pCam )
                    //ARFloat *dist_factor, ARFloat cpara[3][4] )
 {
+    ARFloat  pos3d[P_MAX][3];		// local (not a member) so that poses can be estimated in parallel
     ARFloat  off[3], pmax[3], pmin[3];
     ARFloat  ret;
     int     i;
@@ -161,6 +198,7 @@ AR_TEMPL_TRACKER::arGetTransMat5(ARFloat rot[3][3], ARFloat ppos2d[][2],
 				   Camera *pCam)
 				   //ARFloat *dist_factor, ARFloat cpara[3][4])
 {
+    ARFloat  pos3d[P_MAX][3];
     ARFloat  off[3], pmax[3], pmin[3];
     ARFloat  ret;
     int     i;
@@ -201,6 +239,7 @@ AR_TEMPL_TRACKER::arGetTransMatSub(ARFloat rot[3][3], ARFloat ppos2d[][2],
                      //ARFloat *dist_factor, ARFloat cpara[3][4] )
 {
     ARMat   *mat_a, *mat_b, *mat_c, *mat_d, *mat_e, *mat_f;
+    ARFloat  pos2d[P_MAX][2];
     ARFloat  trans[3];
     ARFloat  wx, wy, wz;
     ARFloat  ret;
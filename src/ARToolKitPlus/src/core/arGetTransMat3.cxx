@@ -354,6 +354,175 @@ AR_TEMPL_TRACKER::arGetInitRot( ARMarkerInfo *marker_info, ARFloat cpara[3][4],
 }
 
 
+// Closed form pose of a square marker (IPPE, Collins & Bartoli 2014).
+// The homography from the marker plane to the normalized image plane is
+// decomposed at the marker center, which gives the two rotations a planar
+// target can not be disambiguated between. For every rotation the
+// translation is solved linearly. Both poses are returned sorted by their
+// mean squared reprojection error (best first), trans relative to the
+// marker center. ppos2d are the ideal corners in the order arGetTransMat()
+// uses. Returns the number of poses or -1.
+//
+AR_TEMPL_FUNC int
+AR_TEMPL_TRACKER::arGetInitPoseIPPE(ARFloat ppos2d[4][2], ARFloat width, ARFloat cpara[3][4],
+									ARFloat rot[2][3][3], ARFloat trans[2][3], ARFloat err[2])
+{
+	ARFloat  x[4], y[4];
+	ARFloat  sx, sy, dx1, dx2, dy1, dy2, del;
+	ARFloat  g, h, a, b, d, e;
+	ARFloat  H[3][3];
+	ARFloat  p, q, j00, j01, j10, j11;
+	ARFloat  vx, vy, vz, w, c;
+	ARFloat  rv[3][3];
+	ARFloat  b00, b01, b10, b11, a00, a01, a10, a11;
+	ARFloat  ata00, ata01, ata11, gamma;
+	ARFloat  rt00, rt01, rt10, rt11, bb0, bb1;
+	ARFloat  lr[3][3];
+	ARFloat  m[4][2];
+	int      i, j, k, s;
+
+	PROFILE_BEGINSEC(profiler, GETINITROT)
+
+	// corners in normalized camera coordinates
+	for( i = 0; i < 4; i++ ) {
+		y[i] = (ppos2d[i][1] - cpara[1][2]) / cpara[1][1];
+		x[i] = (ppos2d[i][0] - cpara[0][2] - cpara[0][1]*y[i]) / cpara[0][0];
+	}
+
+	// homography from the unit square (0,0),(1,0),(1,1),(0,1) to the corners (Heckbert)
+	sx = x[0] - x[1] + x[2] - x[3];
+	sy = y[0] - y[1] + y[2] - y[3];
+	dx1 = x[1] - x[2];  dx2 = x[3] - x[2];
+	dy1 = y[1] - y[2];  dy2 = y[3] - y[2];
+	del = dx1*dy2 - dx2*dy1;
+	if( del == 0 ) {
+		PROFILE_ENDSEC(profiler, GETINITROT)
+		return -1;
+	}
+	g = (sx*dy2 - dx2*sy) / del;
+	h = (dx1*sy - sx*dy1) / del;
+	a = x[1] - x[0] + g*x[1];  b = x[3] - x[0] + h*x[3];
+	d = y[1] - y[0] + g*y[1];  e = y[3] - y[0] + h*y[3];
+
+	// combined with the marker plane -> unit square mapping s = X/width+0.5, t = -Y/width+0.5,
+	// normalized so that H[2][2]==1. (p,q) is the image of the marker center
+	w = 1 / (g*(ARFloat)0.5 + h*(ARFloat)0.5 + 1);
+	H[0][0] =  a/width*w;  H[0][1] = -b/width*w;  H[0][2] = (a*(ARFloat)0.5 + b*(ARFloat)0.5 + x[0])*w;
+	H[1][0] =  d/width*w;  H[1][1] = -e/width*w;  H[1][2] = (d*(ARFloat)0.5 + e*(ARFloat)0.5 + y[0])*w;
+	H[2][0] =  g/width*w;  H[2][1] = -h/width*w;
+	p = H[0][2];
+	q = H[1][2];
+
+	// jacobian of the homography at the marker center
+	j00 = H[0][0] - H[2][0]*p;  j01 = H[0][1] - H[2][1]*p;
+	j10 = H[1][0] - H[2][0]*q;  j11 = H[1][1] - H[2][1]*q;
+
+	// rotation that takes the viewing ray (p,q,1) onto the z axis, transposed
+	w = (ARFloat)sqrt( p*p + q*q + 1 );
+	vx = p/w;  vy = q/w;  vz = 1/w;
+	c = 1 / (1 + vz);
+	rv[0][0] = 1 - vx*vx*c;  rv[0][1] = -vx*vy*c;     rv[0][2] = vx;
+	rv[1][0] = -vx*vy*c;     rv[1][1] = 1 - vy*vy*c;  rv[1][2] = vy;
+	rv[2][0] = -vx;          rv[2][1] = -vy;          rv[2][2] = 1 - (vx*vx + vy*vy)*c;
+
+	b00 = rv[0][0] - p*rv[2][0];  b01 = rv[0][1] - p*rv[2][1];
+	b10 = rv[1][0] - q*rv[2][0];  b11 = rv[1][1] - q*rv[2][1];
+	w = b00*b11 - b01*b10;
+	if( w == 0 ) {
+		PROFILE_ENDSEC(profiler, GETINITROT)
+		return -1;
+	}
+	w = 1 / w;
+	a00 = w*( b11*j00 - b01*j10);  a01 = w*( b11*j01 - b01*j11);
+	a10 = w*(-b10*j00 + b00*j10);  a11 = w*(-b10*j01 + b00*j11);
+
+	// largest singular value of the 2x2 block
+	ata00 = a00*a00 + a01*a01;
+	ata01 = a00*a10 + a01*a11;
+	ata11 = a10*a10 + a11*a11;
+	gamma = (ARFloat)sqrt( (ARFloat)0.5*(ata00 + ata11 + (ARFloat)sqrt((ata00-ata11)*(ata00-ata11) + 4*ata01*ata01)) );
+	if( gamma < (ARFloat)1e-10 ) {
+		PROFILE_ENDSEC(profiler, GETINITROT)
+		return -1;
+	}
+	rt00 = a00/gamma;  rt01 = a01/gamma;
+	rt10 = a10/gamma;  rt11 = a11/gamma;
+	w = 1 - rt00*rt00 - rt10*rt10;  bb0 = (w > 0) ? (ARFloat)sqrt(w) : 0;
+	w = 1 - rt01*rt01 - rt11*rt11;  bb1 = (w > 0) ? (ARFloat)sqrt(w) : 0;
+	if( -rt00*rt01 - rt10*rt11 < 0 ) bb1 = -bb1;
+
+	m[0][0] = -width*(ARFloat)0.5;  m[0][1] =  width*(ARFloat)0.5;
+	m[1][0] =  width*(ARFloat)0.5;  m[1][1] =  width*(ARFloat)0.5;
+	m[2][0] =  width*(ARFloat)0.5;  m[2][1] = -width*(ARFloat)0.5;
+	m[3][0] = -width*(ARFloat)0.5;  m[3][1] = -width*(ARFloat)0.5;
+
+	for( s = 0; s < 2; s++ ) {
+		ARFloat  sg = (s == 0) ? (ARFloat)1 : (ARFloat)-1;
+		ARFloat  n[3][3], r[3], wx, wy, wz, det, err2;
+
+		// local rotation (columns: first two rows of the block completed to an orthonormal basis)
+		lr[0][0] = rt00;     lr[0][1] = rt01;     lr[0][2] = sg*(bb1*rt10 - bb0*rt11);
+		lr[1][0] = rt10;     lr[1][1] = rt11;     lr[1][2] = sg*(bb0*rt01 - bb1*rt00);
+		lr[2][0] = sg*bb0;   lr[2][1] = sg*bb1;   lr[2][2] = rt00*rt11 - rt01*rt10;
+		for( j = 0; j < 3; j++ ) {
+			for( i = 0; i < 3; i++ ) {
+				rot[s][j][i] = rv[j][0]*lr[0][i] + rv[j][1]*lr[1][i] + rv[j][2]*lr[2][i];
+			}
+		}
+
+		// translation: least squares over x*(r3.m + tz) = r1.m + tx, y*(r3.m + tz) = r2.m + ty
+		for( j = 0; j < 3; j++ ) { r[j] = 0; for( i = 0; i < 3; i++ ) n[j][i] = 0; }
+		for( k = 0; k < 4; k++ ) {
+			wx = rot[s][0][0]*m[k][0] + rot[s][0][1]*m[k][1];
+			wy = rot[s][1][0]*m[k][0] + rot[s][1][1]*m[k][1];
+			wz = rot[s][2][0]*m[k][0] + rot[s][2][1]*m[k][1];
+			n[0][0] += 1;  n[0][2] -= x[k];
+			n[1][1] += 1;  n[1][2] -= y[k];
+			n[2][2] += x[k]*x[k] + y[k]*y[k];
+			r[0] += x[k]*wz - wx;
+			r[1] += y[k]*wz - wy;
+			r[2] -= x[k]*(x[k]*wz - wx) + y[k]*(y[k]*wz - wy);
+		}
+		n[2][0] = n[0][2];
+		n[2][1] = n[1][2];
+		det = n[0][0]*n[1][1]*n[2][2] - n[0][0]*n[1][2]*n[2][1] - n[0][2]*n[1][1]*n[2][0];
+		if( det == 0 ) {
+			PROFILE_ENDSEC(profiler, GETINITROT)
+			return -1;
+		}
+		trans[s][2] = (n[0][0]*n[1][1]*r[2] - n[0][0]*n[2][1]*r[1] - n[1][1]*n[2][0]*r[0]) / det;
+		trans[s][0] = (r[0] - n[0][2]*trans[s][2]) / n[0][0];
+		trans[s][1] = (r[1] - n[1][2]*trans[s][2]) / n[1][1];
+
+		// mean squared reprojection error in pixels, as returned by arModifyMatrix()
+		err2 = 0;
+		for( k = 0; k < 4; k++ ) {
+			wx = rot[s][0][0]*m[k][0] + rot[s][0][1]*m[k][1] + trans[s][0];
+			wy = rot[s][1][0]*m[k][0] + rot[s][1][1]*m[k][1] + trans[s][1];
+			wz = rot[s][2][0]*m[k][0] + rot[s][2][1]*m[k][1] + trans[s][2];
+			if( wz <= 0 ) { err2 = -1; break; }
+			det = (cpara[0][0]*wx + cpara[0][1]*wy + cpara[0][2]*wz) / wz - ppos2d[k][0];
+			w   = (cpara[1][1]*wy + cpara[1][2]*wz) / wz - ppos2d[k][1];
+			err2 += det*det + w*w;
+		}
+		err[s] = (err2 < 0) ? err2 : err2/4;
+	}
+
+	PROFILE_ENDSEC(profiler, GETINITROT)
+
+	// sort: poses behind the camera last
+	if( err[0] < 0 || (err[1] >= 0 && err[1] < err[0]) ) {
+		for( j = 0; j < 3; j++ ) {
+			for( i = 0; i < 3; i++ ) { w = rot[0][j][i]; rot[0][j][i] = rot[1][j][i]; rot[1][j][i] = w; }
+			w = trans[0][j]; trans[0][j] = trans[1][j]; trans[1][j] = w;
+		}
+		w = err[0]; err[0] = err[1]; err[1] = w;
+	}
+	if( err[0] < 0 ) return -1;
+	return (err[1] < 0) ? 1 : 2;
+}
+
+
 //////////////////////////////////////////////////////////////
 //
 //             POCKETPC specific code starts here
@@ -54,22 +54,85 @@ AR_TEMPL_TRACKER::arGetTransMatCont2(ARMarkerInfo *marker_info, ARFloat center[2
 AR_TEMPL_FUNC ARFloat
 AR_TEMPL_TRACKER::arGetTransMatCont(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat center[2], ARFloat width, ARFloat conv[3][4])
 {
-    ARFloat  err1, err2;
-    ARFloat wtrans[3][4];
-    int     i, j;
+    ARFloat  err, err2;
+    ARFloat  prev[3][4], wtrans[3][4];
+    ARFloat  rot[3][3];
+    ARFloat  ppos2d[4][2];
+    ARFloat  ppos3d[4][2];
+    ARFloat  irot[2][3][3], itrans[2][3], ierr[2], dot[2];
+    int     dir, nsol, s;
+    int     i, j, k;
 
-    err1 = arGetTransMatContSub(marker_info, prev_conv, center, width, conv);
-    if( err1 > AR_GET_TRANS_CONT_MAT_MAX_FIT_ERROR ) {
+	// prev_conv may be conv (see arGetTransMatCont2)
+    for( j = 0; j < 3; j++ ) {
+        for( i = 0; i < 4; i++ ) prev[j][i] = prev_conv[j][i];
+    }
+
+    dir = marker_info->dir;
+    ppos2d[0][0] = marker_info->vertex[(4-dir)%4][0];
+    ppos2d[0][1] = marker_info->vertex[(4-dir)%4][1];
+    ppos2d[1][0] = marker_info->vertex[(5-dir)%4][0];
+    ppos2d[1][1] = marker_info->vertex[(5-dir)%4][1];
+    ppos2d[2][0] = marker_info->vertex[(6-dir)%4][0];
+    ppos2d[2][1] = marker_info->vertex[(6-dir)%4][1];
+    ppos2d[3][0] = marker_info->vertex[(7-dir)%4][0];
+    ppos2d[3][1] = marker_info->vertex[(7-dir)%4][1];
+    ppos3d[0][0] = center[0] - width*(ARFloat)0.5;
+    ppos3d[0][1] = center[1] + width*(ARFloat)0.5;
+    ppos3d[1][0] = center[0] + width*(ARFloat)0.5;
+    ppos3d[1][1] = center[1] + width*(ARFloat)0.5;
+    ppos3d[2][0] = center[0] + width*(ARFloat)0.5;
+    ppos3d[2][1] = center[1] - width*(ARFloat)0.5;
+    ppos3d[3][0] = center[0] - width*(ARFloat)0.5;
+    ppos3d[3][1] = center[1] - width*(ARFloat)0.5;
+
+	// the closed form pose is cheaper than iterating from the previous rotation.
+	// if both of its solutions fit (or neither does), the one closer to the previous
+	// rotation is used, so the pose does not flip between them from frame to frame
+	nsol = arGetInitPoseIPPE( ppos2d, width, arCamera->mat, irot, itrans, ierr );
+	s = 0;
+	if( nsol > 1 && ( ierr[1] < AR_GET_TRANS_MAT_IPPE_MAX_FIT_ERROR || ierr[0] >= AR_GET_TRANS_MAT_IPPE_MAX_FIT_ERROR ) ) {
+		for( k = 0; k < 2; k++ ) {
+			dot[k] = 0;
+			for( j = 0; j < 3; j++ )
+				for( i = 0; i < 3; i++ ) dot[k] += prev[j][i] * irot[k][j][i];
+		}
+		s = dot[1] > dot[0] ? 1 : 0;
+	}
+
+	if( nsol > 0 && ierr[s] < AR_GET_TRANS_MAT_IPPE_MAX_FIT_ERROR ) {
+		for( j = 0; j < 3; j++ ) {
+			for( i = 0; i < 3; i++ ) conv[j][i] = irot[s][j][i];
+			conv[j][3] = itrans[s][j] - irot[s][j][0]*center[0] - irot[s][j][1]*center[1];
+		}
+		return ierr[s];
+	}
+
+	// otherwise that solution is refined. refining the previous rotation as well
+	// costs twice as much and does not give better poses, so it is only the
+	// initial estimate if there is no closed form solution
+	if( nsol > 0 ) {
+		for( j = 0; j < 3; j++ )
+			for( i = 0; i < 3; i++ ) rot[j][i] = irot[s][j][i];
+		for( k = 0; k < AR_GET_TRANS_MAT_MAX_LOOP_COUNT; k++ ) {
+			err = arGetTransMat3( rot, ppos2d, ppos3d, 4, conv, arCamera);
+			if( err < AR_GET_TRANS_MAT_MAX_FIT_ERROR ) break;
+		}
+		return err;
+	}
+
+    err = arGetTransMatContSub(marker_info, prev, center, width, conv);
+    if( err > AR_GET_TRANS_CONT_MAT_MAX_FIT_ERROR ) {
         err2 = arGetTransMat(marker_info, center, width, wtrans);
-        if( err2 < err1 ) {
+        if( err2 >= 0 && err2 < err ) {
             for( j = 0; j < 3; j++ ) {
                 for( i = 0; i < 4; i++ ) conv[j][i] = wtrans[j][i];
             }
-            err1 = err2;
+            err = err2;
         }
     }
 
-    return err1;
+    return err;
 }
 
 
@@ -83,11 +83,11 @@ put_zero( ARUint8 *p, int size )
 #undef _DEF_PIXEL_FORMAT_LUM
 
 
-AR_TEMPL_FUNC ARInt16*
+AR_TEMPL_FUNC ARLabel*
 AR_TEMPL_TRACKER::arLabeling(ARUint8 *image, int thresh, int *label_num, int **area,
 					ARFloat **pos, int **clip, int **label_ref )
 {
-	ARInt16* ret = NULL;
+	ARLabel* ret = NULL;
 
 	PROFILE_BEGINSEC(profiler, LABELING)
 	//ret = labeling2(image, thresh, label_num, area, pos, clip, label_ref, 1);
@@ -125,20 +125,21 @@ AR_TEMPL_TRACKER::arLabeling(ARUint8 *image, int thresh, int *label_num, int **a
 
 
 #if 0
-AR_TEMPL_FUNC ARInt16*
+AR_TEMPL_FUNC ARLabel*
 AR_TEMPL_TRACKER::labeling2(ARUint8 *image, int thresh, int *label_num, int **area,
 				   ARFloat **pos, int **clip, int **label_ref, int LorR)
 {
     ARUint8   *pnt;                     /*  image pointer       */
-    ARInt16   *pnt1, *pnt2;             /*  image pointer       */
+    ARLabel   *pnt1, *pnt2;             /*  image pointer       */
     int       *wk;                      /*  pointer for work    */
     int       wk_max;                   /*  work                */
     int       m,n;                      /*  work                */
     int       i,j,k;                    /*  for loop            */
     int       lxsize, lysize;
     int       poff;
-    ARInt16   *l_image;
-    int       *work, *work2;
+    ARLabel   *l_image;
+    int       *work;
+    ARLabelSum *work2;
     int       *wlabel_num;
     int       *warea;
     int       *wclip;
@@ -500,13 +501,13 @@ AR_TEMPL_TRACKER::labeling2(ARUint8 *image, int thresh, int *label_num, int **ar
     }
     for(i = 0; i < wk_max; i++) {
         j = work[i] - 1;
-        warea[j]    += work2[i*7+0];
+        warea[j]    += (int)work2[i*7+0];
         wpos[j*2+0] += work2[i*7+1];
         wpos[j*2+1] += work2[i*7+2];
-        if( wclip[j*4+0] > work2[i*7+3] ) wclip[j*4+0] = work2[i*7+3];
-        if( wclip[j*4+1] < work2[i*7+4] ) wclip[j*4+1] = work2[i*7+4];
-        if( wclip[j*4+2] > work2[i*7+5] ) wclip[j*4+2] = work2[i*7+5];
-        if( wclip[j*4+3] < work2[i*7+6] ) wclip[j*4+3] = work2[i*7+6];
+        if( wclip[j*4+0] > work2[i*7+3] ) wclip[j*4+0] = (int)work2[i*7+3];
+        if( wclip[j*4+1] < work2[i*7+4] ) wclip[j*4+1] = (int)work2[i*7+4];
+        if( wclip[j*4+2] > work2[i*7+5] ) wclip[j*4+2] = (int)work2[i*7+5];
+        if( wclip[j*4+3] < work2[i*7+6] ) wclip[j*4+3] = (int)work2[i*7+6];
     }
 
     for( i = 0; i < *label_num; i++ ) {
@@ -514,7 +515,8 @@ AR_TEMPL_TRACKER::labeling2(ARUint8 *image, int thresh, int *label_num, int **ar
         wpos[i*2+1] /= warea[i];
     }
 #else
-	int *wclipRun, *work2Run;
+	int *wclipRun;
+	ARLabelSum *work2Run;
 	int iDown;
 
 	wclipRun = wclip;
@@ -530,29 +532,29 @@ AR_TEMPL_TRACKER::labeling2(ARUint8 *image, int thresh, int *label_num, int **ar
     for(i = 0; i < wk_max; i++) {
         j = work[i] - 1;
 
-        warea[j]    += *work2Run++;
+        warea[j]    += (int)*work2Run++;
         wpos[j*2+0] += *work2Run++;
         wpos[j*2+1] += *work2Run++;
 
 		wclipRun = wclip+j*4;
 
 		if(*wclipRun > *work2Run)
-			*wclipRun = *work2Run;
+			*wclipRun = (int)*work2Run;
 		wclipRun++;
 		work2Run++;
 
 		if(*wclipRun < *work2Run)
-			*wclipRun = *work2Run;
+			*wclipRun = (int)*work2Run;
 		wclipRun++;
 		work2Run++;
 
 		if(*wclipRun > *work2Run)
-			*wclipRun = *work2Run;
+			*wclipRun = (int)*work2Run;
 		wclipRun++;
 		work2Run++;
 
 		if(*wclipRun < *work2Run)
-			*wclipRun = *work2Run;
+			*wclipRun = (int)*work2Run;
 		wclipRun++;
 		work2Run++;
     }
@@ -38,20 +38,22 @@
  * ======================================================================== */
 
 
-AR_TEMPL_FUNC ARInt16*
+AR_TEMPL_FUNC ARLabel*
 AR_TEMPL_TRACKER::LABEL_FUNC_NAME(ARUint8 *image, int thresh, int *label_num, int **area,
 								  ARFloat **pos, int **clip, int **label_ref)
 {
     ARUint8   *pnt;                     /*  image pointer       */
-    ARInt16   *pnt1, *pnt2;             /*  image pointer       */
+    ARLabel   *pnt1, *pnt2;             /*  image pointer       */
     int       *wk;                      /*  pointer for work    */
     int       wk_max;                   /*  work                */
     int       m,n;                      /*  work                */
     int       i,j,k;                    /*  for loop            */
     int       lxsize, lysize;
-    int       poff;
-    ARInt16   *l_image;
-    int       *work, *work2;
+    int       lx0, ly0, lx1, ly1;             /*  labeled area        */
+    int       poff, step;
+    ARLabel   *l_image;
+    int       *work;
+    ARLabelSum *work2;
     int       *wlabel_num;
     int       *warea;
     int       *wclip;
@@ -83,12 +85,32 @@ AR_TEMPL_TRACKER::LABEL_FUNC_NAME(ARUint8 *image, int thresh, int *label_num, in
     if( arImageProcMode == AR_IMAGE_PROC_IN_HALF ) {
         lxsize = arImXsize / 2;
         lysize = arImYsize / 2;
+        step = 2;
     }
     else {
         lxsize = arImXsize;
         lysize = arImYsize;
+        step = 1;
     }
 
+	// label everything but the image border, or only the search region
+	lx0 = ly0 = 1;
+	lx1 = lxsize-2;
+	ly1 = lysize-2;
+	if(searchROIActive)
+	{
+		if(searchROI[0]/step > lx0)  lx0 = searchROI[0]/step;
+		if(searchROI[1]/step > ly0)  ly0 = searchROI[1]/step;
+		if(searchROI[2]/step < lx1)  lx1 = searchROI[2]/step;
+		if(searchROI[3]/step < ly1)  ly1 = searchROI[3]/step;
+		if(lx0>lx1 || ly0>ly1)
+		{
+			lx0 = lx1 = ly0 = ly1 = 1;
+		}
+	}
+	labelROI[0] = lx0;  labelROI[1] = lx1;
+	labelROI[2] = ly0;  labelROI[3] = ly1;
+
     pnt1 = &l_image[0];
     pnt2 = &l_image[(lysize-1)*lxsize];
     for(i = 0; i < lxsize; i++) {
@@ -103,16 +125,28 @@ AR_TEMPL_TRACKER::LABEL_FUNC_NAME(ARUint8 *image, int thresh, int *label_num, in
         pnt2 += lxsize;
     }
 
+	// l_image keeps the labels of earlier frames outside of the search
+	// region, so clear a ring around it for the neighbour lookups below
+	// and for contour tracing
+	if(lx0>1 || ly0>1 || lx1<lxsize-2 || ly1<lysize-2)
+	{
+		pnt1 = &l_image[(ly0-1)*lxsize + lx0-1];
+		pnt2 = &l_image[(ly1+1)*lxsize + lx0-1];
+		for(i = lx0-1; i <= lx1+1; i++) {
+			*(pnt1++) = *(pnt2++) = 0;
+		}
+
+		pnt1 = &l_image[ly0*lxsize + lx0-1];
+		pnt2 = &l_image[ly0*lxsize + lx1+1];
+		for(j = ly0; j <= ly1; j++) {
+			*pnt1 = *pnt2 = 0;
+			pnt1 += lxsize;
+			pnt2 += lxsize;
+		}
+	}
+
     wk_max = 0;
-    pnt2 = &(l_image[lxsize+1]);
-    if( arImageProcMode == AR_IMAGE_PROC_IN_HALF ) {
-        pnt = &(image[(arImXsize*2+2)*pixelSize]);
-        poff = pixelSize*2;
-    }
-    else {
-        pnt = &(image[(arImXsize+1)*pixelSize]);
-        poff = pixelSize;
-    }
+    poff = pixelSize*step;
 
 
 //	int diffCorners = -60,
@@ -132,7 +166,7 @@ AR_TEMPL_TRACKER::LABEL_FUNC_NAME(ARUint8 *image, int thresh, int *label_num, in
 		corrThresh;
 
 
-	for(j = 1; j < lysize-1; j++, pnt+=poff*2, pnt2+=2)
+	for(j = 1; j <= ly1; j++)
 	{
 		if(vignetting.enabled)
 		{
@@ -150,7 +184,21 @@ AR_TEMPL_TRACKER::LABEL_FUNC_NAME(ARUint8 *image, int thresh, int *label_num, in
 			corrCenterY += dCorrCenterY;
 		}
 
-		for(i = 1; i < lxsize-1; i++, pnt+=poff, pnt2++)
+		if(j < ly0)
+			continue;
+
+		if(vignetting.enabled)
+			for(i = 1; i < lx0; i++)
+			{
+				if(i==iHalf)
+					dCorrX = -dCorrX;
+				corrX += dCorrX;
+			}
+
+		pnt2 = &(l_image[j*lxsize + lx0]);
+		pnt = &(image[(j*arImXsize + lx0)*step*pixelSize]);
+
+		for(i = lx0; i <= lx1; i++, pnt+=poff, pnt2++)
 		{
 			if(vignetting.enabled)
 			{
@@ -400,13 +448,13 @@ AR_TEMPL_TRACKER::LABEL_FUNC_NAME(ARUint8 *image, int thresh, int *label_num, in
     }
     for(i = 0; i < wk_max; i++) {
         j = work[i] - 1;
-        warea[j]    += work2[i*7+0];
+        warea[j]    += (int)work2[i*7+0];
         wpos[j*2+0] += work2[i*7+1];
         wpos[j*2+1] += work2[i*7+2];
-        if( wclip[j*4+0] > work2[i*7+3] ) wclip[j*4+0] = work2[i*7+3];
-        if( wclip[j*4+1] < work2[i*7+4] ) wclip[j*4+1] = work2[i*7+4];
-        if( wclip[j*4+2] > work2[i*7+5] ) wclip[j*4+2] = work2[i*7+5];
-        if( wclip[j*4+3] < work2[i*7+6] ) wclip[j*4+3] = work2[i*7+6];
+        if( wclip[j*4+0] > work2[i*7+3] ) wclip[j*4+0] = (int)work2[i*7+3];
+        if( wclip[j*4+1] < work2[i*7+4] ) wclip[j*4+1] = (int)work2[i*7+4];
+        if( wclip[j*4+2] > work2[i*7+5] ) wclip[j*4+2] = (int)work2[i*7+5];
+        if( wclip[j*4+3] < work2[i*7+6] ) wclip[j*4+3] = (int)work2[i*7+6];
     }
 
     for( i = 0; i < *label_num; i++ ) {
@@ -414,7 +462,8 @@ AR_TEMPL_TRACKER::LABEL_FUNC_NAME(ARUint8 *image, int thresh, int *label_num, in
         wpos[i*2+1] /= warea[i];
     }
 #else
-	int *wclipRun, *work2Run;
+	int *wclipRun;
+	ARLabelSum *work2Run;
 	int iDown;
 
 	wclipRun = wclip;
@@ -430,29 +479,29 @@ AR_TEMPL_TRACKER::LABEL_FUNC_NAME(ARUint8 *image, int thresh, int *label_num, in
     for(i = 0; i < wk_max; i++) {
         j = work[i] - 1;
 
-        warea[j]    += *work2Run++;
+        warea[j]    += (int)*work2Run++;
         wpos[j*2+0] += *work2Run++;
         wpos[j*2+1] += *work2Run++;
 
 		wclipRun = wclip+j*4;
 
 		if(*wclipRun > *work2Run)
-			*wclipRun = *work2Run;
+			*wclipRun = (int)*work2Run;
 		wclipRun++;
 		work2Run++;
 
 		if(*wclipRun < *work2Run)
-			*wclipRun = *work2Run;
+			*wclipRun = (int)*work2Run;
 		wclipRun++;
 		work2Run++;
 
 		if(*wclipRun > *work2Run)
-			*wclipRun = *work2Run;
+			*wclipRun = (int)*work2Run;
 		wclipRun++;
 		work2Run++;
 
 		if(*wclipRun < *work2Run)
-			*wclipRun = *work2Run;
+			*wclipRun = (int)*work2Run;
 		wclipRun++;
 		work2Run++;
     }
@@ -82,9 +82,18 @@ AR_TEMPL_TRACKER::arMultiFreeConfig( ARMultiMarkerInfoT *config )
 {
     int    i;
 
-    for( i = 0; i < config->marker_num; i++ ) {
-        arFreePatt( config->marker[i].patt_id );
+    if( config->ownsPatterns ) {
+        for( i = 0; i < config->marker_num; i++ ) {
+            arFreePatt( config->marker[i].patt_id );
+        }
     }
+    free( config->idToMarker );
+    free( config->idScratch );
+    free( config->pos2d );
+    free( config->pos3d );
+    free( config->rppPos2d );
+    free( config->rppPos3d );
+    free( config->winfo );
     free( config->marker );
     free( config );
     config = NULL;
@@ -0,0 +1,204 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ARToolKitPlus/Tracker.h>
+#include <ARToolKitPlus/arMultiBoard.h>
+#include <ARToolKitPlus/extra/MappedFile.h>
+
+
+namespace ARToolKitPlus {
+
+
+AR_TEMPL_FUNC ARMultiMarkerInfoT*
+AR_TEMPL_TRACKER::arMultiReadConfigBinary(const char *filename)
+{
+	MappedFile				file;
+	const ARMultiBoardHeader *header;
+	const ARUint8			*ptr;
+	const ARInt32			*idTable;
+	ARMultiEachMarkerInfoT	*marker;
+	ARMultiMarkerInfoT		*marker_info;
+	size_t					expectedSize;
+	int						numMarkers, idTableSize;
+	int						i;
+
+	if(!file.open(filename))
+		return NULL;
+
+	if(file.getSize() < sizeof(ARMultiBoardHeader))
+		return NULL;
+
+	// the mapping is page aligned, so the header can be accessed directly
+	//
+	header = (const ARMultiBoardHeader*)file.getData();
+
+	if(memcmp(header->magic, "ARMB", 4) != 0 || header->version != ARMULTIBOARD_VERSION) {
+		if(logger)
+			logger->artLogEx("ARToolKitPlus: '%s' is not a multi-marker board or has an unsupported version", filename);
+		return NULL;
+	}
+
+	if(header->byteOrder != ARMULTIBOARD_BYTEORDER || header->floatSize != sizeof(ARFloat)) {
+		if(logger)
+			logger->artLogEx("ARToolKitPlus: multi-marker board '%s' was compiled for a different tracker configuration", filename);
+		return NULL;
+	}
+
+	numMarkers = (int)header->numMarkers;
+	idTableSize = (int)header->idTableSize;
+
+	expectedSize = sizeof(ARMultiBoardHeader) + numMarkers*arMultiBoardRecordSize() + idTableSize*sizeof(ARInt32);
+	if(numMarkers <= 0 || idTableSize <= 0 || file.getSize() != expectedSize) {
+		if(logger)
+			logger->artLogEx("ARToolKitPlus: multi-marker board '%s' is corrupt", filename);
+		return NULL;
+	}
+
+	if( (marker = (ARMultiEachMarkerInfoT *)malloc( sizeof(ARMultiEachMarkerInfoT) * numMarkers )) == NULL )
+		return NULL;
+
+	// records are not aligned to sizeof(ARFloat), so they are copied field by field
+	//
+	ptr = file.getData() + sizeof(ARMultiBoardHeader);
+	for( i = 0; i < numMarkers; i++ ) {
+		ARInt32 id;
+		memcpy(&id, ptr, sizeof(ARInt32));								ptr += sizeof(ARInt32);
+		memcpy(&marker[i].width, ptr, sizeof(ARFloat));					ptr += sizeof(ARFloat);
+		memcpy(marker[i].center, ptr, 2*sizeof(ARFloat));				ptr += 2*sizeof(ARFloat);
+		memcpy(marker[i].trans, ptr, 12*sizeof(ARFloat));				ptr += 12*sizeof(ARFloat);
+		memcpy(marker[i].itrans, ptr, 12*sizeof(ARFloat));				ptr += 12*sizeof(ARFloat);
+		memcpy(marker[i].pos3d, ptr, 12*sizeof(ARFloat));				ptr += 12*sizeof(ARFloat);
+
+		if(id < 0 || id >= idTableSize) {
+			free(marker);
+			if(logger)
+				logger->artLogEx("ARToolKitPlus: multi-marker board '%s' is corrupt", filename);
+			return NULL;
+		}
+		marker[i].patt_id = id;
+		marker[i].visible = marker[i].visibleR = -1;
+	}
+
+	// the id table is only used if it agrees with the markers
+	//
+	idTable = (const ARInt32*)ptr;
+	for( i = 0; i < idTableSize; i++ ) {
+		ARInt32 idx;
+		memcpy(&idx, idTable+i, sizeof(ARInt32));
+		if(idx < -1 || idx >= numMarkers || (idx >= 0 && marker[idx].patt_id != i)) break;
+	}
+	if(i < idTableSize) {
+		free(marker);
+		if(logger)
+			logger->artLogEx("ARToolKitPlus: multi-marker board '%s' is corrupt", filename);
+		return NULL;
+	}
+
+	marker_info = (ARMultiMarkerInfoT *)malloc( sizeof(ARMultiMarkerInfoT) );
+	if( marker_info == NULL ) {free(marker); return NULL;}
+	marker_info->marker       = marker;
+	marker_info->marker_num   = numMarkers;
+	marker_info->prevF        = 0;
+	marker_info->ownsPatterns = 0;
+
+	if( arMultiSetupLookup(marker_info, idTable) < 0 || marker_info->idTableSize != idTableSize ) {
+		arMultiFreeConfig(marker_info);
+		return NULL;
+	}
+
+	return marker_info;
+}
+
+
+AR_TEMPL_FUNC int
+AR_TEMPL_TRACKER::arMultiSaveConfigBinary(ARMultiMarkerInfoT *config, const char *filename)
+{
+	ARMultiBoardHeader		header;
+	FILE					*fp;
+	ARInt32					id;
+	int						i;
+
+	if(config == NULL || config->marker_num <= 0 || config->idTableSize <= 0)
+		return -1;
+
+	memcpy(header.magic, "ARMB", 4);
+	header.version = ARMULTIBOARD_VERSION;
+	header.byteOrder = ARMULTIBOARD_BYTEORDER;
+	header.floatSize = sizeof(ARFloat);
+	header.numMarkers = config->marker_num;
+	header.idTableSize = config->idTableSize;
+
+	if( (fp=fopen(filename, "wb")) == NULL ) {
+		printf("\"%s\" could not be opened for writing!!\n", filename);
+		return -1;
+	}
+
+	fwrite(&header, sizeof(header), 1, fp);
+
+	for( i = 0; i < config->marker_num; i++ ) {
+		id = config->marker[i].patt_id;
+		fwrite(&id, sizeof(ARInt32), 1, fp);
+		fwrite(&config->marker[i].width, sizeof(ARFloat), 1, fp);
+		fwrite(config->marker[i].center, sizeof(ARFloat), 2, fp);
+		fwrite(config->marker[i].trans, sizeof(ARFloat), 12, fp);
+		fwrite(config->marker[i].itrans, sizeof(ARFloat), 12, fp);
+		fwrite(config->marker[i].pos3d, sizeof(ARFloat), 12, fp);
+	}
+
+	for( i = 0; i < config->idTableSize; i++ ) {
+		id = config->idToMarker[i];
+		fwrite(&id, sizeof(ARInt32), 1, fp);
+	}
+
+	if(ferror(fp)) {
+		fclose(fp);
+		printf("Multi-marker board write error!!\n");
+		return -1;
+	}
+	fclose(fp);
+
+	return config->marker_num;
+}
+
+
+}  // namespace ARToolKitPlus
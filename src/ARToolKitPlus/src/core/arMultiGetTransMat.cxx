@@ -55,15 +55,9 @@ namespace ARToolKitPlus {
 #define  THRESH_3           10.0
 #define  AR_MULTI_GET_TRANS_MAT_MAX_LOOP_COUNT   2
 #define  AR_MULTI_GET_TRANS_MAT_MAX_FIT_ERROR    10.0
-
-typedef struct {
-    ARFloat   pos[4][2];
-    ARFloat   thresh;
-    ARFloat   err;
-    int      marker;
-    int      dir;
-} arMultiEachMarkerInternalInfoT;
-
+// mean squared corner distance (pixels^2) between a detected marker and its
+// projection through the previous rig pose to take part in the fast path
+#define  AR_MULTI_GET_TRANS_MAT_GATE_MAX_ERROR   100.0
 
 AR_TEMPL_FUNC ARFloat
 AR_TEMPL_TRACKER::arMultiGetTransMat(ARMarkerInfo *marker_info, int marker_num, ARMultiMarkerInfoT *config)
@@ -72,25 +66,85 @@ AR_TEMPL_TRACKER::arMultiGetTransMat(ARMarkerInfo *marker_info, int marker_num,
     ARFloat                rot[3][3], trans1[3][4], trans2[3][4];
     ARFloat                err = 0, err2;
     int                   max, max_area = 0, max_marker, vnum;
-    int                   dir;
-    int                   i, j, k;
+    int                   dir, id, verified = 0;
+    int                   i, j, k, l;
 
     if( config->prevF ) {
-        verify_markers( marker_info, marker_num, config );
+        verified = (verify_markers( marker_info, marker_num, config ) == 0);
     }
 
-    max = -1;
-    vnum = 0;
+    // best (first most confident) detected marker per pattern id
+    for( j = 0; j < marker_num; j++ ) {
+        id = marker_info[j].id;
+        if( id < 0 || id >= config->idTableSize ) continue;
+        if( config->idToMarker[id] < 0 ) continue;
+        if( marker_info[j].cf < 0.70 ) continue;
+
+        k = config->idScratch[id];
+        if( k == -1 || marker_info[k].cf < marker_info[j].cf ) config->idScratch[id] = j;
+    }
     for( i = 0; i < config->marker_num; i++ ) {
-        k = -1;
-        for( j = 0; j < marker_num; j++ ) {
-            if( marker_info[j].id != config->marker[i].patt_id ) continue;
-            if( marker_info[j].cf < 0.70 ) continue;
+        id = config->marker[i].patt_id;
+        config->marker[i].visible = (id >= 0 && id < config->idTableSize) ? config->idScratch[id] : -1;
+    }
+    for( j = 0; j < marker_num; j++ ) {
+        id = marker_info[j].id;
+        if( id >= 0 && id < config->idTableSize ) config->idScratch[id] = -1;
+    }
+
+    pos2d = config->pos2d;
+    pos3d = config->pos3d;
+
+    // fast path: the previous rig pose is valid and verify_markers() has already
+    // projected every marker through it, so gate the markers by that reprojection
+    // error instead of estimating a pose for each of them.
+    if( verified ) {
+        vnum = 0;
+        for( i = 0; i < config->marker_num; i++ ) {
+            if( (k=config->marker[i].visible) == -1 ) continue;
+            if( config->winfo[i].marker != k ) continue;
+            if( config->winfo[i].err > 4*AR_MULTI_GET_TRANS_MAT_GATE_MAX_ERROR ) continue;
+
+            dir = marker_info[k].dir;
+            for( l = 0; l < 4; l++ ) {
+                pos2d[vnum*8+l*2+0] = marker_info[k].vertex[(4-dir+l)%4][0];
+                pos2d[vnum*8+l*2+1] = marker_info[k].vertex[(4-dir+l)%4][1];
+                pos3d[vnum*12+l*3+0] = config->marker[i].pos3d[l][0];
+                pos3d[vnum*12+l*3+1] = config->marker[i].pos3d[l][1];
+                pos3d[vnum*12+l*3+2] = config->marker[i].pos3d[l][2];
+            }
+            vnum++;
+        }
 
-            if( k == -1 ) k = j;
-            else if( marker_info[k].cf < marker_info[j].cf ) k = j;
+        if( vnum > 0 ) {
+            for( j = 0; j < 3; j++ ) {
+                for( i = 0; i < 3; i++ ) {
+                    rot[j][i] = config->trans[j][i];
+                }
+            }
+            for( i = 0; i < AR_MULTI_GET_TRANS_MAT_MAX_LOOP_COUNT; i++ ) {
+                err = arGetTransMat4( rot, (ARFloat (*)[2])pos2d,
+                                           (ARFloat (*)[3])pos3d,
+                                            vnum*4, trans1 );
+                if( err < AR_MULTI_GET_TRANS_MAT_MAX_FIT_ERROR ) break;
+            }
+            if( err < THRESH_2 ) {
+                for( j = 0; j < 3; j++ ) {
+                    for( i = 0; i < 4; i++ ) {
+                        config->trans[j][i] = trans1[j][i];
+                    }
+                }
+                config->prevF = 1;
+                return err;
+            }
         }
-        if( (config->marker[i].visible=k) == -1) continue;
+    }
+
+    // reinitialization: estimate every visible marker on its own
+    max = -1;
+    vnum = 0;
+    for( i = 0; i < config->marker_num; i++ ) {
+        if( (k=config->marker[i].visible) == -1) continue;
 
 		// Changed by Daniel: use the selected pose estimator for this now. i'm though not sure if
 		//                    it is wise to use arGetTransMatCont for multi-marker tracking...
@@ -126,8 +180,6 @@ AR_TEMPL_TRACKER::arMultiGetTransMat(ARMarkerInfo *marker_info, int marker_num,
         return -1;
     }
 
-    arMalloc(pos2d, ARFloat, vnum*4*2);
-    arMalloc(pos3d, ARFloat, vnum*4*3);
 
     j = 0;
     for( i = 0; i < config->marker_num; i++ ) {
@@ -172,8 +224,6 @@ AR_TEMPL_TRACKER::arMultiGetTransMat(ARMarkerInfo *marker_info, int marker_num,
 
         if( err < THRESH_2 ) {
             config->prevF = 1;
-            free(pos3d);
-            free(pos2d);
             return err;
         }
     }
@@ -207,8 +257,6 @@ AR_TEMPL_TRACKER::arMultiGetTransMat(ARMarkerInfo *marker_info, int marker_num,
         config->prevF = 0;
     }
 
-    free(pos3d);
-    free(pos2d);
     return err;
 }
 
@@ -226,7 +274,7 @@ AR_TEMPL_TRACKER::verify_markers(ARMarkerInfo *marker_info, int marker_num, ARMu
     int                            w1, w2;
     int                            i, j, k;
 
-    arMalloc(winfo,arMultiEachMarkerInternalInfoT,config->marker_num);
+    winfo = config->winfo;
 
     for( i = 0; i < config->marker_num; i++ ) {
 		arUtilMatMul(config->trans, config->marker[i].trans, wtrans);
@@ -355,7 +403,6 @@ printf("\n");
 	printf("w1,w2 = %d,%d\n", w1, w2);
 #endif
     if( w2 >= w1 ) {
-        free(winfo);
         return -1;
     }
 
@@ -370,8 +417,6 @@ printf("\n");
         }
     }
 
-    free(winfo);
-
     return 0;
 }
 
@@ -91,6 +91,13 @@ AR_TEMPL_TRACKER::arMultiReadConfigFile(const char *filename)
     if( (fp=fopen(filename,"r")) == NULL ) return NULL;
 
     get_buff(buf, 256, fp);
+
+    // compiled boards (see arMultiSaveConfigBinary()) are recognized by their magic
+    if( strncmp(buf, "ARMB", 4) == 0 ) {
+        fclose(fp);
+        return arMultiReadConfigBinary(filename);
+    }
+
     if( sscanf(buf, "%d", &num) != 1 ) {fclose(fp); return NULL;}
 
     arMalloc(marker,ARMultiEachMarkerInfoT,num);
@@ -171,9 +178,57 @@ AR_TEMPL_TRACKER::arMultiReadConfigFile(const char *filename)
     marker_info->marker     = marker;
     marker_info->marker_num = num;
     marker_info->prevF      = 0;
+    marker_info->ownsPatterns = 1;
+
+    if( arMultiSetupLookup(marker_info) < 0 ) {
+        arMultiFreeConfig(marker_info);
+        return NULL;
+    }
 
     return marker_info;
 }
 
 
+AR_TEMPL_FUNC int
+AR_TEMPL_TRACKER::arMultiSetupLookup(ARMultiMarkerInfoT *config, const ARInt32 *idToMarker)
+{
+    int    i, size = 0;
+
+    for( i = 0; i < config->marker_num; i++ ) {
+        if( config->marker[i].patt_id >= size ) size = config->marker[i].patt_id + 1;
+    }
+
+    config->idTableSize = size;
+    config->idToMarker  = (int *)malloc( sizeof(int) * (size > 0 ? size : 1) );
+    config->idScratch   = (int *)malloc( sizeof(int) * (size > 0 ? size : 1) );
+    config->pos2d       = (ARFloat *)malloc( sizeof(ARFloat) * (config->marker_num*4*2 + 1) );
+    config->pos3d       = (ARFloat *)malloc( sizeof(ARFloat) * (config->marker_num*4*3 + 1) );
+    config->rppPos2d    = (double (*)[3])malloc( sizeof(double[3]) * (config->marker_num*4 + 1) );
+    config->rppPos3d    = (double (*)[3])malloc( sizeof(double[3]) * (config->marker_num*4 + 1) );
+    config->winfo       = (arMultiEachMarkerInternalInfoT *)malloc( sizeof(arMultiEachMarkerInternalInfoT) * (config->marker_num + 1) );
+
+    if( config->idToMarker == NULL || config->idScratch == NULL || config->pos2d == NULL || config->pos3d == NULL
+     || config->rppPos2d == NULL || config->rppPos3d == NULL || config->winfo == NULL ) {
+        return -1;
+    }
+
+    for( i = 0; i < size; i++ ) {
+        config->idToMarker[i] = -1;
+        config->idScratch[i]  = -1;
+    }
+
+    if( idToMarker != NULL ) {
+        memcpy( config->idToMarker, idToMarker, sizeof(int) * size );
+        return 0;
+    }
+
+    // several config markers may share a pattern; the first one wins (as before)
+    for( i = config->marker_num-1; i >= 0; i-- ) {
+        if( config->marker[i].patt_id >= 0 ) config->idToMarker[config->marker[i].patt_id] = i;
+    }
+
+    return 0;
+}
+
+
 }  // namespace ARToolKitPlus
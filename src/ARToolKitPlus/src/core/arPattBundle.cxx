@@ -0,0 +1,244 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include <ARToolKitPlus/Tracker.h>
+#include <ARToolKitPlus/arPattBundle.h>
+#include <ARToolKitPlus/extra/MappedFile.h>
+
+
+namespace ARToolKitPlus {
+
+
+AR_TEMPL_FUNC int
+AR_TEMPL_TRACKER::arLoadPattBundle(const char *filename)
+{
+	const int		patSize = PATTERN_HEIGHT*PATTERN_WIDTH*3;
+	const int		patSizeBW = PATTERN_HEIGHT*PATTERN_WIDTH;
+	MappedFile		file;
+	const ARPattBundleHeader *header;
+	const ARUint8	*ptr;
+	size_t			expectedSize;
+	int				numPatterns, evecDim, patno;
+	int				h, i, j, k;
+	bool			wasEmpty;
+
+	assert(sizeof(int)==sizeof(ARInt32));
+
+	if(pattern_num == -1) {
+		for( i = 0; i < MAX_LOAD_PATTERNS; i++ ) patf[i] = 0;
+		pattern_num = 0;
+	}
+
+	if(!file.open(filename)) {
+		printf("\"%s\" not found!!\n", filename);
+		return -1;
+	}
+
+	if(file.getSize() < sizeof(ARPattBundleHeader)) {
+		printf("\"%s\" is not a pattern bundle!!\n", filename);
+		return -1;
+	}
+
+	// the mapping is page aligned, so the header can be accessed directly
+	//
+	header = (const ARPattBundleHeader*)file.getData();
+
+	if(memcmp(header->magic, "ARPB", 4) != 0 || header->version != ARPATTBUNDLE_VERSION) {
+		printf("\"%s\" is not a pattern bundle or has an unsupported version!!\n", filename);
+		return -1;
+	}
+
+	if(header->byteOrder != ARPATTBUNDLE_BYTEORDER || header->floatSize != sizeof(ARFloat) ||
+	   header->pattWidth != PATTERN_WIDTH || header->pattHeight != PATTERN_HEIGHT || header->evecDim > EVEC_MAX) {
+		if(logger)
+			logger->artLogEx("ARToolKitPlus: pattern bundle '%s' was compiled for a different tracker configuration", filename);
+		return -1;
+	}
+
+	numPatterns = (int)header->numPatterns;
+	evecDim = (int)header->evecDim;
+
+	expectedSize = sizeof(ARPattBundleHeader) + numPatterns*arPattBundleRecordSize(PATTERN_WIDTH, PATTERN_HEIGHT);
+	if(evecDim > 0)
+		expectedSize += (evecDim*patSize + numPatterns*4*evecDim)*sizeof(ARFloat);
+
+	if(numPatterns <= 0 || file.getSize() != expectedSize) {
+		printf("Pattern bundle read error!!\n");
+		return -1;
+	}
+
+	// the bundle's patterns are put into consecutive slots so that
+	// their ids keep the order in which they were compiled
+	//
+	for( patno = 0; patno + numPatterns <= MAX_LOAD_PATTERNS; patno++ ) {
+		for( i = 0; i < numPatterns; i++ )
+			if(patf[patno+i] != 0) break;
+		if( i == numPatterns ) break;
+	}
+	if( patno + numPatterns > MAX_LOAD_PATTERNS ) {
+		if(logger)
+			logger->artLogEx("ARToolKitPlus: no room for %d patterns from bundle '%s'", numPatterns, filename);
+		return -1;
+	}
+
+	wasEmpty = (pattern_num == 0);
+	ptr = file.getData() + sizeof(ARPattBundleHeader);
+
+	for( i = 0; i < numPatterns; i++ ) {
+		k = patno + i;
+		for( h = 0; h < 4; h++ ) {
+			memcpy(pat[k][h], ptr, patSize*sizeof(ARInt32));
+			ptr += patSize*sizeof(ARInt32);
+		}
+		for( h = 0; h < 4; h++ ) {
+			memcpy(patBW[k][h], ptr, patSizeBW*sizeof(ARInt32));
+			ptr += patSizeBW*sizeof(ARInt32);
+		}
+		memcpy(patpow[k], ptr, 4*sizeof(ARFloat));
+		ptr += 4*sizeof(ARFloat);
+		memcpy(patpowBW[k], ptr, 4*sizeof(ARFloat));
+		ptr += 4*sizeof(ARFloat);
+
+		patf[k] = 1;
+	}
+	pattern_num += numPatterns;
+
+	// a stored eigen-basis is only valid if the bundle makes up the whole library
+	//
+	if(evecDim > 0 && wasEmpty) {
+		for( j = 0; j < evecDim; j++ ) {
+			memcpy(evec[j], ptr, patSize*sizeof(ARFloat));
+			ptr += patSize*sizeof(ARFloat);
+		}
+		for( i = 0; i < numPatterns; i++ ) {
+			for( h = 0; h < 4; h++ ) {
+				memcpy(epat[patno+i][h], ptr, evecDim*sizeof(ARFloat));
+				ptr += evecDim*sizeof(ARFloat);
+			}
+		}
+		evec_dim = evecDim;
+		evecf = 1;
+		evecDirty = false;
+	}
+	else
+	{
+		evecf = 0;
+		evecDirty = true;
+	}
+
+	return patno;
+}
+
+
+AR_TEMPL_FUNC int
+AR_TEMPL_TRACKER::arSavePattBundle(const char *filename)
+{
+	const int		patSize = PATTERN_HEIGHT*PATTERN_WIDTH*3;
+	const int		patSizeBW = PATTERN_HEIGHT*PATTERN_WIDTH;
+	ARPattBundleHeader header;
+	FILE			*fp;
+	int				h, j, k;
+
+	assert(sizeof(int)==sizeof(ARInt32));
+
+	if(pattern_num <= 0)
+		return -1;
+
+	// make sure the stored eigen-basis is up to date
+	//
+	if(arMatchingPCAMode == AR_MATCHING_WITH_PCA && evecDirty) {
+		gen_evec();
+		evecDirty = false;
+	}
+
+	memcpy(header.magic, "ARPB", 4);
+	header.version = ARPATTBUNDLE_VERSION;
+	header.byteOrder = ARPATTBUNDLE_BYTEORDER;
+	header.floatSize = sizeof(ARFloat);
+	header.pattWidth = PATTERN_WIDTH;
+	header.pattHeight = PATTERN_HEIGHT;
+	header.numPatterns = 0;
+	header.evecDim = (evecf && !evecDirty) ? evec_dim : 0;		// never store an outdated basis
+
+	for( k = 0; k < MAX_LOAD_PATTERNS; k++ )
+		if(patf[k] != 0) header.numPatterns++;
+
+	if( (fp=fopen(filename, "wb")) == NULL ) {
+		printf("\"%s\" could not be opened for writing!!\n", filename);
+		return -1;
+	}
+
+	fwrite(&header, sizeof(header), 1, fp);
+
+	for( k = 0; k < MAX_LOAD_PATTERNS; k++ ) {
+		if(patf[k] == 0) continue;
+		for( h = 0; h < 4; h++ )
+			fwrite(pat[k][h], sizeof(ARInt32), patSize, fp);
+		for( h = 0; h < 4; h++ )
+			fwrite(patBW[k][h], sizeof(ARInt32), patSizeBW, fp);
+		fwrite(patpow[k], sizeof(ARFloat), 4, fp);
+		fwrite(patpowBW[k], sizeof(ARFloat), 4, fp);
+	}
+
+	if(header.evecDim > 0) {
+		for( j = 0; j < (int)header.evecDim; j++ )
+			fwrite(evec[j], sizeof(ARFloat), patSize, fp);
+		for( k = 0; k < MAX_LOAD_PATTERNS; k++ ) {
+			if(patf[k] == 0) continue;
+			for( h = 0; h < 4; h++ )
+				fwrite(epat[k][h], sizeof(ARFloat), header.evecDim, fp);
+		}
+	}
+
+	if(ferror(fp)) {
+		fclose(fp);
+		printf("Pattern bundle write error!!\n");
+		return -1;
+	}
+	fclose(fp);
+
+	return (int)header.numPatterns;
+}
+
+
+}  // namespace ARToolKitPlus
@@ -66,15 +66,17 @@ AR_TEMPL_TRACKER::arInitCparam(Camera *pCam)
 	// if the camera parameters change, the undistortion LUT has to be rebuilt.
 	// (this is done automatically in arParamObserv2Ideal_LUT or arParamIdeal2Observ_LUT)
 	//
-	if(undistO2ITable && (arImXsize!=pCam->xsize || arImYsize!=pCam->ysize))
-	{
-		artkp_Free(undistO2ITable);
-		undistO2ITable = NULL;
-	}
+	if(arImXsize!=pCam->xsize || arImYsize!=pCam->ysize)
+		freeUndistTables();
 
 	arImXsize = pCam->xsize;
 	arImYsize = pCam->ysize;
 
+	// markers get larger with the resolution
+	arAreaMax = AR_AREA_MAX;
+	if(arImXsize*arImYsize > AR_AREA_MAX_REFERENCE_PIXELS)
+		arAreaMax = (int)((double)AR_AREA_MAX*arImXsize*arImYsize/AR_AREA_MAX_REFERENCE_PIXELS);
+
     return(0);
 }
 
@@ -107,9 +109,13 @@ AR_TEMPL_TRACKER::arGetLine2(int x_coord[], int y_coord[], int coord_num,
         n = ed - st + 1;
         input  = Matrix::alloc( n, 2 );
         for( j = 0; j < n; j++ ) {
-			// does not work
-            (this->*arParamObserv2Ideal_func)( pCam, (ARFloat)x_coord[st+j], (ARFloat)y_coord[st+j], &(input->m[j*2+0]), &(input->m[j*2+1]) );
-			//
+            arGetLine_ox[j] = (ARFloat)x_coord[st+j];
+            arGetLine_oy[j] = (ARFloat)y_coord[st+j];
+        }
+        arParamObserv2IdealBatch( pCam, n, arGetLine_ox, arGetLine_oy, arGetLine_ix, arGetLine_iy );
+        for( j = 0; j < n; j++ ) {
+            input->m[j*2+0] = arGetLine_ix[j];
+            input->m[j*2+1] = arGetLine_iy[j];
         }
         if( arMatrixPCA(input, evec, ev, mean) < 0 ) {
             Matrix::free( input );
@@ -0,0 +1,644 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+#include <stdlib.h>
+#include <math.h>
+
+#include <ARToolKitPlus/Tracker.h>
+
+
+namespace ARToolKitPlus {
+
+
+// eigen decomposition of a symmetric n x n matrix (cyclic jacobi). a gets destroyed,
+// the eigenvectors are the columns of v, eigenvalues are sorted in ascending order.
+//
+static void lmJacobiEigen(double *a, int n, double *ev, double *v)
+{
+	int     i, j, k, p, q, sweep;
+	double  off, theta, t, c, s, tau, g, h;
+
+	for( i = 0; i < n; i++ )
+		for( j = 0; j < n; j++ ) v[i*n+j] = (i == j) ? 1.0 : 0.0;
+
+	for( sweep = 0; sweep < 50; sweep++ ) {
+		off = 0;
+		for( p = 0; p < n; p++ )
+			for( q = p+1; q < n; q++ ) off += a[p*n+q]*a[p*n+q];
+		if( off < 1e-30 ) break;
+
+		for( p = 0; p < n; p++ ) {
+			for( q = p+1; q < n; q++ ) {
+				if( fabs(a[p*n+q]) < 1e-300 ) continue;
+				theta = (a[q*n+q] - a[p*n+p]) / (2*a[p*n+q]);
+				t = (theta >= 0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta*theta + 1));
+				c = 1 / sqrt(t*t + 1);
+				s = t*c;
+				tau = s / (1 + c);
+				h = t*a[p*n+q];
+				a[p*n+p] -= h;
+				a[q*n+q] += h;
+				a[p*n+q] = a[q*n+p] = 0;
+				for( k = 0; k < n; k++ ) {
+					if( k != p && k != q ) {
+						g = a[k*n+p];  h = a[k*n+q];
+						a[k*n+p] = a[p*n+k] = g - s*(h + g*tau);
+						a[k*n+q] = a[q*n+k] = h + s*(g - h*tau);
+					}
+					g = v[k*n+p];  h = v[k*n+q];
+					v[k*n+p] = g - s*(h + g*tau);
+					v[k*n+q] = h + s*(g - h*tau);
+				}
+			}
+		}
+	}
+
+	for( i = 0; i < n; i++ ) ev[i] = a[i*n+i];
+
+	// selection sort, ascending
+	for( i = 0; i < n-1; i++ ) {
+		k = i;
+		for( j = i+1; j < n; j++ ) if( ev[j] < ev[k] ) k = j;
+		if( k == i ) continue;
+		t = ev[i]; ev[i] = ev[k]; ev[k] = t;
+		for( j = 0; j < n; j++ ) { t = v[j*n+i]; v[j*n+i] = v[j*n+k]; v[j*n+k] = t; }
+	}
+}
+
+
+// solves the symmetric positive definite system a x = b (cholesky), n <= 6.
+// returns false if a is not positive definite
+//
+static bool lmSolveSPD(const double *a, const double *b, double *x, int n)
+{
+	double  l[36], y[6], s;
+	int     i, j, k;
+
+	for( i = 0; i < n; i++ ) {
+		for( j = 0; j <= i; j++ ) {
+			s = a[i*n+j];
+			for( k = 0; k < j; k++ ) s -= l[i*n+k]*l[j*n+k];
+			if( i == j ) {
+				if( s <= 0 ) return false;
+				l[i*n+i] = sqrt(s);
+			}
+			else l[i*n+j] = s / l[j*n+j];
+		}
+	}
+	for( i = 0; i < n; i++ ) {
+		s = b[i];
+		for( k = 0; k < i; k++ ) s -= l[i*n+k]*y[k];
+		y[i] = s / l[i*n+i];
+	}
+	for( i = n-1; i >= 0; i-- ) {
+		s = y[i];
+		for( k = i+1; k < n; k++ ) s -= l[k*n+i]*x[k];
+		x[i] = s / l[i*n+i];
+	}
+	return true;
+}
+
+
+// least squares solution of the 6 x n system a x = b via the normal equations, n <= 5
+//
+static bool lmSolveLSQ6(const double a[6][10], const int *cols, int n, const double b[6], double *x)
+{
+	double  ata[25], atb[5];
+	int     i, j, k;
+
+	for( i = 0; i < n; i++ ) {
+		atb[i] = 0;
+		for( k = 0; k < 6; k++ ) atb[i] += a[k][cols[i]]*b[k];
+		for( j = 0; j < n; j++ ) {
+			ata[i*n+j] = 0;
+			for( k = 0; k < 6; k++ ) ata[i*n+j] += a[k][cols[i]]*a[k][cols[j]];
+		}
+	}
+	return lmSolveSPD(ata, atb, x, n);
+}
+
+
+// rotation and translation that map the points pw onto pc (absolute orientation,
+// Horn's quaternion method)
+//
+static void lmAbsoluteOrientation(const double (*pw)[3], const double (*pc)[3], int num, double R[3][3], double t[3])
+{
+	double  cw[3] = {0,0,0}, cc[3] = {0,0,0};
+	double  S[3][3], N[16], ev[4], V[16], q0, qx, qy, qz;
+	int     i, j, k;
+
+	for( i = 0; i < num; i++ )
+		for( j = 0; j < 3; j++ ) { cw[j] += pw[i][j]; cc[j] += pc[i][j]; }
+	for( j = 0; j < 3; j++ ) { cw[j] /= num; cc[j] /= num; }
+
+	for( j = 0; j < 3; j++ )
+		for( k = 0; k < 3; k++ ) {
+			S[j][k] = 0;
+			for( i = 0; i < num; i++ ) S[j][k] += (pw[i][j] - cw[j])*(pc[i][k] - cc[k]);
+		}
+
+	N[0]  = S[0][0] + S[1][1] + S[2][2];
+	N[1]  = S[1][2] - S[2][1];
+	N[2]  = S[2][0] - S[0][2];
+	N[3]  = S[0][1] - S[1][0];
+	N[5]  = S[0][0] - S[1][1] - S[2][2];
+	N[6]  = S[0][1] + S[1][0];
+	N[7]  = S[2][0] + S[0][2];
+	N[10] = -S[0][0] + S[1][1] - S[2][2];
+	N[11] = S[1][2] + S[2][1];
+	N[15] = -S[0][0] - S[1][1] + S[2][2];
+	N[4] = N[1];  N[8] = N[2];  N[9] = N[6];  N[12] = N[3];  N[13] = N[7];  N[14] = N[11];
+
+	// quaternion = eigenvector of the largest eigenvalue
+	lmJacobiEigen(N, 4, ev, V);
+	q0 = V[3];  qx = V[7];  qy = V[11];  qz = V[15];
+
+	R[0][0] = q0*q0 + qx*qx - qy*qy - qz*qz;
+	R[0][1] = 2*(qx*qy - q0*qz);
+	R[0][2] = 2*(qx*qz + q0*qy);
+	R[1][0] = 2*(qy*qx + q0*qz);
+	R[1][1] = q0*q0 - qx*qx + qy*qy - qz*qz;
+	R[1][2] = 2*(qy*qz - q0*qx);
+	R[2][0] = 2*(qz*qx - q0*qy);
+	R[2][1] = 2*(qz*qy + q0*qx);
+	R[2][2] = q0*q0 - qx*qx - qy*qy + qz*qz;
+
+	for( j = 0; j < 3; j++ ) t[j] = cc[j] - (R[j][0]*cw[0] + R[j][1]*cw[1] + R[j][2]*cw[2]);
+}
+
+
+// EPnP (Lepetit, Moreno-Noguer, Fua 2009) for non-planar point sets. The points are
+// expressed as weighted sums of four control points whose camera coordinates span the
+// null space of a 2num x 12 system. The betas of the 1, 2 and 3 dimensional null space
+// approximations are refined with gauss newton and the best pose is returned.
+// ppos2d are ideal image coordinates. Returns the mean squared reprojection error
+// or -1 for planar or degenerate point sets (use a different initial pose for those).
+//
+AR_TEMPL_FUNC ARFloat
+AR_TEMPL_TRACKER::arGetInitPoseEPnP(ARFloat ppos2d[][2], ARFloat ppos3d[][3], int num, ARFloat conv[3][4])
+{
+	double  cw[4][3], cov[9], cev[3], cvec[9];
+	double  ci[3][3], det, d[3];
+	double  M[144], Mev[12], Mv[144];
+	double  L[6][10], rho[6], betas[4], bx[5];
+	double  ccs[4][3], R[3][3], t[3];
+	double  best_err = -1, err, dx, dy, x, y, z;
+	double  (*alphas)[4], (*pw)[3], (*pc)[3], (*xn)[2];
+	double  row0[12], row1[12];
+	int     i, j, k, n, it;
+	static const int cols1[4] = {0, 1, 3, 6};
+	static const int cols2[3] = {0, 1, 2};
+	static const int cols3[5] = {0, 1, 2, 3, 4};
+
+	if( num < 6 ) return -1;
+
+	alphas = (double (*)[4])malloc(num*(sizeof(double[4]) + 2*sizeof(double[3]) + sizeof(double[2])));
+	if( alphas == NULL ) return -1;
+	pw = (double (*)[3])(alphas + num);
+	pc = pw + num;
+	xn = (double (*)[2])(pc + num);
+
+	// control points: centroid and principal axes
+	for( j = 0; j < 3; j++ ) cw[0][j] = 0;
+	for( i = 0; i < num; i++ )
+		for( j = 0; j < 3; j++ ) { pw[i][j] = ppos3d[i][j]; cw[0][j] += pw[i][j]; }
+	for( j = 0; j < 3; j++ ) cw[0][j] /= num;
+	for( j = 0; j < 3; j++ )
+		for( k = 0; k < 3; k++ ) {
+			cov[j*3+k] = 0;
+			for( i = 0; i < num; i++ ) cov[j*3+k] += (pw[i][j] - cw[0][j])*(pw[i][k] - cw[0][k]);
+		}
+	lmJacobiEigen(cov, 3, cev, cvec);
+	if( cev[0] <= AR_LM_EPNP_MIN_THICKNESS*cev[2] ) {
+		free(alphas);
+		return -1;
+	}
+	for( k = 0; k < 3; k++ ) {
+		x = sqrt(cev[k]/num);
+		for( j = 0; j < 3; j++ ) cw[k+1][j] = cw[0][j] + x*cvec[j*3+k];
+	}
+
+	// barycentric coordinates of the points
+	for( j = 0; j < 3; j++ )
+		for( k = 0; k < 3; k++ ) ci[j][k] = cw[k+1][j] - cw[0][j];
+	det = ci[0][0]*(ci[1][1]*ci[2][2] - ci[1][2]*ci[2][1])
+	    - ci[0][1]*(ci[1][0]*ci[2][2] - ci[1][2]*ci[2][0])
+	    + ci[0][2]*(ci[1][0]*ci[2][1] - ci[1][1]*ci[2][0]);
+	for( i = 0; i < num; i++ ) {
+		for( j = 0; j < 3; j++ ) d[j] = pw[i][j] - cw[0][j];
+		alphas[i][1] = ( d[0]*(ci[1][1]*ci[2][2] - ci[1][2]*ci[2][1])
+		               - ci[0][1]*(d[1]*ci[2][2] - ci[1][2]*d[2])
+		               + ci[0][2]*(d[1]*ci[2][1] - ci[1][1]*d[2]) ) / det;
+		alphas[i][2] = ( ci[0][0]*(d[1]*ci[2][2] - ci[1][2]*d[2])
+		               - d[0]*(ci[1][0]*ci[2][2] - ci[1][2]*ci[2][0])
+		               + ci[0][2]*(ci[1][0]*d[2] - d[1]*ci[2][0]) ) / det;
+		alphas[i][3] = ( ci[0][0]*(ci[1][1]*d[2] - d[1]*ci[2][1])
+		               - ci[0][1]*(ci[1][0]*d[2] - d[1]*ci[2][0])
+		               + d[0]*(ci[1][0]*ci[2][1] - ci[1][1]*ci[2][0]) ) / det;
+		alphas[i][0] = 1 - alphas[i][1] - alphas[i][2] - alphas[i][3];
+	}
+
+	// M^T M in normalized camera coordinates
+	for( i = 0; i < 144; i++ ) M[i] = 0;
+	for( i = 0; i < num; i++ ) {
+		xn[i][1] = (ppos2d[i][1] - arCamera->mat[1][2]) / arCamera->mat[1][1];
+		xn[i][0] = (ppos2d[i][0] - arCamera->mat[0][2] - arCamera->mat[0][1]*xn[i][1]) / arCamera->mat[0][0];
+		for( k = 0; k < 4; k++ ) {
+			row0[3*k+0] = alphas[i][k];  row0[3*k+1] = 0;             row0[3*k+2] = -alphas[i][k]*xn[i][0];
+			row1[3*k+0] = 0;             row1[3*k+1] = alphas[i][k];  row1[3*k+2] = -alphas[i][k]*xn[i][1];
+		}
+		for( j = 0; j < 12; j++ )
+			for( k = j; k < 12; k++ ) M[j*12+k] += row0[j]*row0[k] + row1[j]*row1[k];
+	}
+	for( j = 0; j < 12; j++ )
+		for( k = 0; k < j; k++ ) M[j*12+k] = M[k*12+j];
+	lmJacobiEigen(M, 12, Mev, Mv);
+
+	// L (6 x 10) and rho: distances between the control points in both frames
+	{
+		double  dv[4][6][3];
+		int     a, b;
+		for( n = 0; n < 4; n++ ) {
+			a = 0;  b = 1;
+			for( j = 0; j < 6; j++ ) {
+				for( k = 0; k < 3; k++ ) dv[n][j][k] = Mv[(3*a+k)*12+n] - Mv[(3*b+k)*12+n];
+				if( ++b > 3 ) { a++; b = a+1; }
+			}
+		}
+		for( j = 0; j < 6; j++ ) {
+#define LM_DOT(p,q) (dv[p][j][0]*dv[q][j][0] + dv[p][j][1]*dv[q][j][1] + dv[p][j][2]*dv[q][j][2])
+			L[j][0] =   LM_DOT(0,0);
+			L[j][1] = 2*LM_DOT(0,1);
+			L[j][2] =   LM_DOT(1,1);
+			L[j][3] = 2*LM_DOT(0,2);
+			L[j][4] = 2*LM_DOT(1,2);
+			L[j][5] =   LM_DOT(2,2);
+			L[j][6] = 2*LM_DOT(0,3);
+			L[j][7] = 2*LM_DOT(1,3);
+			L[j][8] = 2*LM_DOT(2,3);
+			L[j][9] =   LM_DOT(3,3);
+#undef LM_DOT
+		}
+		a = 0;  b = 1;
+		for( j = 0; j < 6; j++ ) {
+			rho[j] = 0;
+			for( k = 0; k < 3; k++ ) rho[j] += (cw[a][k] - cw[b][k])*(cw[a][k] - cw[b][k]);
+			if( ++b > 3 ) { a++; b = a+1; }
+		}
+	}
+
+	for( n = 1; n <= 3; n++ ) {
+		// initial betas from the linearized distance constraints
+		betas[0] = betas[1] = betas[2] = betas[3] = 0;
+		if( n == 1 ) {
+			if( !lmSolveLSQ6(L, cols1, 4, rho, bx) ) continue;
+			betas[0] = sqrt(fabs(bx[0]));
+			if( betas[0] == 0 ) continue;
+			for( k = 1; k < 4; k++ ) betas[k] = ((bx[0] < 0) ? -bx[k] : bx[k]) / betas[0];
+		}
+		else {
+			if( !lmSolveLSQ6(L, (n == 2) ? cols2 : cols3, (n == 2) ? 3 : 5, rho, bx) ) continue;
+			if( bx[0] < 0 ) {
+				betas[0] = sqrt(-bx[0]);
+				betas[1] = (bx[2] < 0) ? sqrt(-bx[2]) : 0.0;
+			}
+			else {
+				betas[0] = sqrt(bx[0]);
+				betas[1] = (bx[2] > 0) ? sqrt(bx[2]) : 0.0;
+			}
+			if( bx[1] < 0 ) betas[0] = -betas[0];
+			if( n == 3 && betas[0] != 0 ) betas[2] = bx[3] / betas[0];
+		}
+
+		// gauss newton on the betas
+		for( it = 0; it < 5; it++ ) {
+			double  A[6][10], r[6], ata[16], atr[4], db[4];
+			for( j = 0; j < 6; j++ ) {
+				const double *l = L[j];
+				A[j][0] = 2*l[0]*betas[0] +   l[1]*betas[1] +   l[3]*betas[2] +   l[6]*betas[3];
+				A[j][1] =   l[1]*betas[0] + 2*l[2]*betas[1] +   l[4]*betas[2] +   l[7]*betas[3];
+				A[j][2] =   l[3]*betas[0] +   l[4]*betas[1] + 2*l[5]*betas[2] +   l[8]*betas[3];
+				A[j][3] =   l[6]*betas[0] +   l[7]*betas[1] +   l[8]*betas[2] + 2*l[9]*betas[3];
+				r[j] = rho[j] - ( l[0]*betas[0]*betas[0] + l[1]*betas[0]*betas[1] + l[2]*betas[1]*betas[1]
+				                + l[3]*betas[0]*betas[2] + l[4]*betas[1]*betas[2] + l[5]*betas[2]*betas[2]
+				                + l[6]*betas[0]*betas[3] + l[7]*betas[1]*betas[3] + l[8]*betas[2]*betas[3]
+				                + l[9]*betas[3]*betas[3] );
+			}
+			for( j = 0; j < 4; j++ ) {
+				atr[j] = 0;
+				for( i = 0; i < 6; i++ ) atr[j] += A[i][j]*r[i];
+				for( k = 0; k < 4; k++ ) {
+					ata[j*4+k] = (j == k) ? 1e-12 : 0;
+					for( i = 0; i < 6; i++ ) ata[j*4+k] += A[i][j]*A[i][k];
+				}
+			}
+			if( !lmSolveSPD(ata, atr, db, 4) ) break;
+			for( j = 0; j < 4; j++ ) betas[j] += db[j];
+		}
+
+		// control points and points in camera coordinates
+		for( j = 0; j < 4; j++ )
+			for( k = 0; k < 3; k++ )
+				ccs[j][k] = betas[0]*Mv[(3*j+k)*12+0] + betas[1]*Mv[(3*j+k)*12+1]
+				          + betas[2]*Mv[(3*j+k)*12+2] + betas[3]*Mv[(3*j+k)*12+3];
+		for( i = 0; i < num; i++ )
+			for( k = 0; k < 3; k++ )
+				pc[i][k] = alphas[i][0]*ccs[0][k] + alphas[i][1]*ccs[1][k] + alphas[i][2]*ccs[2][k] + alphas[i][3]*ccs[3][k];
+		if( pc[0][2] < 0 ) {
+			for( i = 0; i < num; i++ )
+				for( k = 0; k < 3; k++ ) pc[i][k] = -pc[i][k];
+		}
+
+		lmAbsoluteOrientation(pw, pc, num, R, t);
+
+		err = 0;
+		for( i = 0; i < num; i++ ) {
+			x = R[0][0]*pw[i][0] + R[0][1]*pw[i][1] + R[0][2]*pw[i][2] + t[0];
+			y = R[1][0]*pw[i][0] + R[1][1]*pw[i][1] + R[1][2]*pw[i][2] + t[1];
+			z = R[2][0]*pw[i][0] + R[2][1]*pw[i][1] + R[2][2]*pw[i][2] + t[2];
+			if( z <= 0 ) { err = -1; break; }
+			dx = (arCamera->mat[0][0]*x + arCamera->mat[0][1]*y)/z + arCamera->mat[0][2] - ppos2d[i][0];
+			dy = arCamera->mat[1][1]*y/z + arCamera->mat[1][2] - ppos2d[i][1];
+			err += dx*dx + dy*dy;
+		}
+		if( err < 0 ) continue;
+		err /= num;
+
+		if( best_err < 0 || err < best_err ) {
+			best_err = err;
+			for( j = 0; j < 3; j++ ) {
+				for( k = 0; k < 3; k++ ) conv[j][k] = (ARFloat)R[j][k];
+				conv[j][3] = (ARFloat)t[j];
+			}
+		}
+	}
+
+	free(alphas);
+	return (ARFloat)best_err;
+}
+
+
+// Levenberg-Marquardt refinement of conv (in place) on the reprojection error of
+// num points. The rotation is updated multiplicatively (exp map), the jacobian is
+// analytic. Works for planar and non-planar point sets. Returns the mean squared
+// reprojection error like arGetTransMat4().
+//
+AR_TEMPL_FUNC ARFloat
+AR_TEMPL_TRACKER::arRefinePoseLM(ARFloat ppos2d[][2], ARFloat ppos3d[][3], int num, ARFloat conv[3][4])
+{
+	const double  fx = arCamera->mat[0][0], sk = arCamera->mat[0][1], cx = arCamera->mat[0][2];
+	const double  fy = arCamera->mat[1][1], cy = arCamera->mat[1][2];
+	double  R[3][3], t[3], Rn[3][3], tn[3];
+	double  JtJ[36], Jtr[6], A[36], delta[6];
+	double  err, nerr, lambda = 1e-3;
+	double  qx, qy, qz, x, y, z, iz, ru, rv, ju[6], jv[6];
+	double  w[3], th, c, s, vc, K[3][3];
+	int     i, j, k, it;
+
+	for( j = 0; j < 3; j++ ) {
+		for( k = 0; k < 3; k++ ) R[j][k] = conv[j][k];
+		t[j] = conv[j][3];
+	}
+
+	err = -1;
+	for( it = 0; it < AR_LM_MAX_ITERATIONS; it++ ) {
+		// residuals and normal equations at the current pose
+		if( err < 0 ) {
+			for( j = 0; j < 36; j++ ) JtJ[j] = 0;
+			for( j = 0; j < 6; j++ ) Jtr[j] = 0;
+			err = 0;
+			for( i = 0; i < num; i++ ) {
+				qx = R[0][0]*ppos3d[i][0] + R[0][1]*ppos3d[i][1] + R[0][2]*ppos3d[i][2];
+				qy = R[1][0]*ppos3d[i][0] + R[1][1]*ppos3d[i][1] + R[1][2]*ppos3d[i][2];
+				qz = R[2][0]*ppos3d[i][0] + R[2][1]*ppos3d[i][1] + R[2][2]*ppos3d[i][2];
+				x = qx + t[0];  y = qy + t[1];  z = qz + t[2];
+				if( z <= 0 ) return -1;
+				iz = 1/z;
+				ru = (fx*x + sk*y)*iz + cx - ppos2d[i][0];
+				rv = fy*y*iz + cy - ppos2d[i][1];
+				err += ru*ru + rv*rv;
+
+				// d(u,v)/d(camera point), chained with d(camera point)/d(w,t) = [ -[q]x | I ]
+				{
+					const double  dux = fx*iz, duy = sk*iz, duz = -(fx*x + sk*y)*iz*iz;
+					const double  dvy = fy*iz, dvz = -fy*y*iz*iz;
+					ju[0] =  duy*(-qz) + duz*qy;
+					ju[1] =  dux*qz    - duz*qx;
+					ju[2] = -dux*qy    + duy*qx;
+					ju[3] = dux;  ju[4] = duy;  ju[5] = duz;
+					jv[0] =  dvy*(-qz) + dvz*qy;
+					jv[1] = -dvz*qx;
+					jv[2] =  dvy*qx;
+					jv[3] = 0;    jv[4] = dvy;  jv[5] = dvz;
+				}
+				for( j = 0; j < 6; j++ ) {
+					Jtr[j] += ju[j]*ru + jv[j]*rv;
+					for( k = j; k < 6; k++ ) JtJ[j*6+k] += ju[j]*ju[k] + jv[j]*jv[k];
+				}
+			}
+			for( j = 0; j < 6; j++ )
+				for( k = 0; k < j; k++ ) JtJ[j*6+k] = JtJ[k*6+j];
+		}
+
+		// damped step
+		for( j = 0; j < 36; j++ ) A[j] = JtJ[j];
+		for( j = 0; j < 6; j++ ) { A[j*7] += lambda*JtJ[j*7]; Jtr[j] = -Jtr[j]; }
+		k = lmSolveSPD(A, Jtr, delta, 6);
+		for( j = 0; j < 6; j++ ) Jtr[j] = -Jtr[j];
+		if( !k ) break;
+
+		// R' = exp([w]x) R, t' = t + dt
+		w[0] = delta[0];  w[1] = delta[1];  w[2] = delta[2];
+		th = sqrt(w[0]*w[0] + w[1]*w[1] + w[2]*w[2]);
+		if( th > 1e-12 ) {
+			c = cos(th);  s = sin(th);  vc = 1 - c;
+			x = w[0]/th;  y = w[1]/th;  z = w[2]/th;
+			K[0][0] = c + x*x*vc;    K[0][1] = x*y*vc - z*s;  K[0][2] = x*z*vc + y*s;
+			K[1][0] = y*x*vc + z*s;  K[1][1] = c + y*y*vc;    K[1][2] = y*z*vc - x*s;
+			K[2][0] = z*x*vc - y*s;  K[2][1] = z*y*vc + x*s;  K[2][2] = c + z*z*vc;
+		}
+		else {
+			for( j = 0; j < 3; j++ )
+				for( k = 0; k < 3; k++ ) K[j][k] = (j == k) ? 1.0 : 0.0;
+		}
+		for( j = 0; j < 3; j++ ) {
+			for( k = 0; k < 3; k++ ) Rn[j][k] = K[j][0]*R[0][k] + K[j][1]*R[1][k] + K[j][2]*R[2][k];
+			tn[j] = t[j] + delta[3+j];
+		}
+
+		nerr = 0;
+		for( i = 0; i < num && nerr >= 0; i++ ) {
+			x = Rn[0][0]*ppos3d[i][0] + Rn[0][1]*ppos3d[i][1] + Rn[0][2]*ppos3d[i][2] + tn[0];
+			y = Rn[1][0]*ppos3d[i][0] + Rn[1][1]*ppos3d[i][1] + Rn[1][2]*ppos3d[i][2] + tn[1];
+			z = Rn[2][0]*ppos3d[i][0] + Rn[2][1]*ppos3d[i][1] + Rn[2][2]*ppos3d[i][2] + tn[2];
+			if( z <= 0 ) { nerr = -1; break; }
+			ru = (fx*x + sk*y)/z + cx - ppos2d[i][0];
+			rv = fy*y/z + cy - ppos2d[i][1];
+			nerr += ru*ru + rv*rv;
+		}
+
+		if( nerr >= 0 && nerr < err ) {
+			for( j = 0; j < 3; j++ ) {
+				for( k = 0; k < 3; k++ ) R[j][k] = Rn[j][k];
+				t[j] = tn[j];
+			}
+			lambda *= 0.1;
+			if( err - nerr < AR_LM_MIN_ERROR_DECREASE*err ) { err = nerr; break; }
+			err = -1;
+		}
+		else {
+			lambda *= 10;
+		}
+	}
+
+	// the loop may end without the error of the final pose
+	if( err < 0 ) {
+		err = 0;
+		for( i = 0; i < num; i++ ) {
+			x = R[0][0]*ppos3d[i][0] + R[0][1]*ppos3d[i][1] + R[0][2]*ppos3d[i][2] + t[0];
+			y = R[1][0]*ppos3d[i][0] + R[1][1]*ppos3d[i][1] + R[1][2]*ppos3d[i][2] + t[1];
+			z = R[2][0]*ppos3d[i][0] + R[2][1]*ppos3d[i][1] + R[2][2]*ppos3d[i][2] + t[2];
+			if( z <= 0 ) return -1;
+			ru = (fx*x + sk*y)/z + cx - ppos2d[i][0];
+			rv = fy*y/z + cy - ppos2d[i][1];
+			err += ru*ru + rv*rv;
+		}
+	}
+
+	for( j = 0; j < 3; j++ ) {
+		for( k = 0; k < 3; k++ ) conv[j][k] = (ARFloat)R[j][k];
+		conv[j][3] = (ARFloat)t[j];
+	}
+
+	return (ARFloat)(err/num);
+}
+
+
+AR_TEMPL_FUNC ARFloat
+AR_TEMPL_TRACKER::lmGetTransMat(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4])
+{
+	return lmGetTransMatSub(marker_info, NULL, center, width, conv);
+}
+
+
+AR_TEMPL_FUNC ARFloat
+AR_TEMPL_TRACKER::lmGetTransMatCont(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat center[2], ARFloat width, ARFloat conv[3][4])
+{
+	ARFloat err1, err2;
+	ARFloat wtrans[3][4];
+
+	err1 = lmGetTransMatSub(marker_info, prev_conv, center, width, conv);
+	if(err1 < 0 || err1 > AR_GET_TRANS_CONT_MAT_MAX_FIT_ERROR)
+	{
+		err2 = lmGetTransMatSub(marker_info, NULL, center, width, wtrans);
+		if(err2 >= 0 && (err1 < 0 || err2 < err1))
+		{
+			for(int j=0; j<3; j++)
+				for(int i=0; i<4; i++)
+					conv[j][i] = wtrans[j][i];
+			err1 = err2;
+		}
+	}
+
+	return err1;
+}
+
+
+// prev_conv==NULL: starts from the closed form (IPPE) poses
+//
+AR_TEMPL_FUNC ARFloat
+AR_TEMPL_TRACKER::lmGetTransMatSub(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat center[2], ARFloat width, ARFloat conv[3][4])
+{
+	ARFloat  ppos2d[4][2];
+	ARFloat  ppos3d[4][3];
+	ARFloat  irot[2][3][3], itrans[2][3], ierr[2];
+	ARFloat  wconv[3][4], err, werr;
+	int      dir, i, j, k, s, nsol;
+
+	dir = marker_info->dir;
+	for( i = 0; i < 4; i++ ) {
+		ppos2d[i][0] = marker_info->vertex[(4-dir+i)%4][0];
+		ppos2d[i][1] = marker_info->vertex[(4-dir+i)%4][1];
+	}
+	ppos3d[0][0] = center[0] - width*(ARFloat)0.5;
+	ppos3d[0][1] = center[1] + width*(ARFloat)0.5;
+	ppos3d[1][0] = center[0] + width*(ARFloat)0.5;
+	ppos3d[1][1] = center[1] + width*(ARFloat)0.5;
+	ppos3d[2][0] = center[0] + width*(ARFloat)0.5;
+	ppos3d[2][1] = center[1] - width*(ARFloat)0.5;
+	ppos3d[3][0] = center[0] - width*(ARFloat)0.5;
+	ppos3d[3][1] = center[1] - width*(ARFloat)0.5;
+	ppos3d[0][2] = ppos3d[1][2] = ppos3d[2][2] = ppos3d[3][2] = 0;
+
+	if( prev_conv ) {
+		for( j = 0; j < 3; j++ )
+			for( k = 0; k < 4; k++ ) conv[j][k] = prev_conv[j][k];
+		return arRefinePoseLM( ppos2d, ppos3d, 4, conv );
+	}
+
+	nsol = arGetInitPoseIPPE( ppos2d, width, arCamera->mat, irot, itrans, ierr );
+	if( nsol <= 0 ) {
+		if( arGetTransMat( marker_info, center, width, conv ) < 0 ) return -1;
+		return arRefinePoseLM( ppos2d, ppos3d, 4, conv );
+	}
+
+	// the second (ambiguous) pose is only refined if it fit better than the refined first one
+	err = -1;
+	for( s = 0; s < nsol; s++ ) {
+		if( s > 0 && ierr[s] >= err ) break;
+
+		for( j = 0; j < 3; j++ ) {
+			for( k = 0; k < 3; k++ ) wconv[j][k] = irot[s][j][k];
+			wconv[j][3] = itrans[s][j] - irot[s][j][0]*center[0] - irot[s][j][1]*center[1];
+		}
+		werr = arRefinePoseLM( ppos2d, ppos3d, 4, wconv );
+		if( werr < 0 ) continue;
+
+		if( err < 0 || werr < err ) {
+			for( j = 0; j < 3; j++ )
+				for( k = 0; k < 4; k++ ) conv[j][k] = wconv[j][k];
+			err = werr;
+		}
+	}
+
+	return err;
+}
+
+
+}  // namespace ARToolKitPlus
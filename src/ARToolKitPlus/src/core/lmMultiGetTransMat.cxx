@@ -0,0 +1,133 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <ARToolKitPlus/Tracker.h>
+
+
+namespace ARToolKitPlus {
+
+// all corners of all markers of the config are refined jointly, so this also works for
+// non-planar rigs such as marker cubes. without a valid previous pose the rig pose is
+// initialized with EPnP or, for planar configs, from the largest marker.
+//
+AR_TEMPL_FUNC ARFloat
+AR_TEMPL_TRACKER::lmMultiGetTransMat(ARMarkerInfo *marker_info, int marker_num, ARMultiMarkerInfoT *config)
+{
+	ARFloat (*pos2d)[2] = (ARFloat (*)[2])config->pos2d;
+	ARFloat (*pos3d)[3] = (ARFloat (*)[3])config->pos3d;
+	ARFloat  ptrans[3][4], wtrans[3][4], trans1[3][4], err = -1, err2;
+	int      *idScratch = config->idScratch;
+	const int idTableSize = config->idTableSize;
+	int      max_m = -1, max_c = -1, max_area = 0;
+	int      n_markers = 0;
+	int      m, c, i, j, dir;
+
+	// idScratch[id] becomes the index of the only detected marker with that id,
+	// or -2 if the id has been detected more than once (such markers are ignored)
+	for( m = 0; m < marker_num; m++ ) {
+		const int id = marker_info[m].id;
+		if( id >= 0 && id < idTableSize && config->idToMarker[id] >= 0 )
+			idScratch[id] = (idScratch[id] == -1) ? m : -2;
+	}
+
+	for( m = 0; m < marker_num; m++ ) {
+		const int id = marker_info[m].id;
+		if( id < 0 || id >= idTableSize ) continue;
+		c = config->idToMarker[id];
+		const bool unique = (idScratch[id] == m);
+		idScratch[id] = -1;
+		if( c < 0 || !unique ) continue;
+
+		dir = marker_info[m].dir;
+		for( i = 0; i < 4; i++ ) {
+			pos2d[4*n_markers+i][0] = marker_info[m].vertex[(4-dir+i)%4][0];
+			pos2d[4*n_markers+i][1] = marker_info[m].vertex[(4-dir+i)%4][1];
+			for( j = 0; j < 3; j++ ) pos3d[4*n_markers+i][j] = config->marker[c].pos3d[i][j];
+		}
+		if( max_m == -1 || marker_info[m].area > max_area ) {
+			max_m = m;
+			max_c = c;
+			max_area = marker_info[m].area;
+		}
+		n_markers++;
+	}
+
+	if( n_markers == 0 ) {
+		config->prevF = 0;
+		return -1;
+	}
+
+	// warm start from the previous rig pose
+	if( config->prevF ) {
+		for( j = 0; j < 3; j++ )
+			for( i = 0; i < 4; i++ ) ptrans[j][i] = config->trans[j][i];
+		err = arRefinePoseLM( pos2d, pos3d, 4*n_markers, ptrans );
+		if( err >= 0 && err < AR_LM_MULTI_MAX_FIT_ERROR ) {
+			for( j = 0; j < 3; j++ )
+				for( i = 0; i < 4; i++ ) config->trans[j][i] = ptrans[j][i];
+			return err;
+		}
+	}
+
+	// cold start
+	err2 = arGetInitPoseEPnP( pos2d, pos3d, 4*n_markers, wtrans );
+	if( err2 < 0 ) {
+		err2 = lmGetTransMat( &marker_info[max_m], config->marker[max_c].center, config->marker[max_c].width, trans1 );
+		if( err2 >= 0 ) arUtilMatMul( trans1, config->marker[max_c].itrans, wtrans );
+	}
+	if( err2 >= 0 ) err2 = arRefinePoseLM( pos2d, pos3d, 4*n_markers, wtrans );
+
+	if( err2 >= 0 && (err < 0 || err2 < err) ) {
+		err = err2;
+		for( j = 0; j < 3; j++ )
+			for( i = 0; i < 4; i++ ) config->trans[j][i] = wtrans[j][i];
+	}
+	else if( err >= 0 ) {
+		for( j = 0; j < 3; j++ )
+			for( i = 0; i < 4; i++ ) config->trans[j][i] = ptrans[j][i];
+	}
+
+	config->prevF = (err >= 0 && err < AR_LM_MULTI_MAX_FIT_ERROR) ? 1 : 0;
+	return err;
+}
+
+}  // namespace ARToolKitPlus
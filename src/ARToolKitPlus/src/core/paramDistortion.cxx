@@ -43,6 +43,7 @@
 #include <ARToolKitPlus/Tracker.h>
 #include <ARToolKitPlus/Camera.h>
 #include <ARToolKitPlus/param.h>
+#include <ARToolKitPlus/arUndistLUT.h>
 
 
 namespace ARToolKitPlus {
@@ -74,8 +75,28 @@ AR_TEMPL_TRACKER::arParamObserv2Ideal_none(Camera* pCam, ARFloat ox, ARFloat oy,
 //
 //  these functions store 2 values (x & y) in a single 32-bit unsigned integer
 //  each value is stored as 11.5 fixed point
+//  (AR_HIGH_RESOLUTION: two 32-bit integers, 24.8 fixed point, see ARUndistEntry)
 //
 
+#ifdef AR_HIGH_RESOLUTION
+
+inline
+void floatToFixed(ARFloat nX, ARFloat nY, ARUndistEntry &nFixed)
+{
+	nFixed.x = (ARInt32)(nX * 256);
+	nFixed.y = (ARInt32)(nY * 256);
+}
+
+
+inline
+void fixedToFloat(const ARUndistEntry& nFixed, ARFloat& nX, ARFloat& nY)
+{
+	nX = nFixed.x/256.0f;
+	nY = nFixed.y/256.0f;
+}
+
+#else
+
 inline
 void floatToFixed(ARFloat nX, ARFloat nY, unsigned int &nFixed)
 {
@@ -102,12 +123,18 @@ void fixedToFloat(unsigned int nFixed, ARFloat& nX, ARFloat& nY)
 	nY = (*sy)/32.0f;
 }
 
+#endif //AR_HIGH_RESOLUTION
+
 
 AR_TEMPL_FUNC int
 AR_TEMPL_TRACKER::arParamObserv2Ideal_LUT(Camera* pCam, ARFloat ox, ARFloat oy, ARFloat *ix, ARFloat *iy)
 {
 	if(!undistO2ITable)
+	{
 		buildUndistO2ITable(pCam);
+		if(!undistO2ITable)
+			return arParamObserv2Ideal_std(pCam, ox,oy, ix,iy);
+	}
 
 	int x=(int)ox, y=(int)oy;
 
@@ -116,67 +143,348 @@ AR_TEMPL_TRACKER::arParamObserv2Ideal_LUT(Camera* pCam, ARFloat ox, ARFloat oy,
 }
 
 
+AR_TEMPL_FUNC int
+AR_TEMPL_TRACKER::arParamObserv2Ideal_LUTSparse(Camera* pCam, ARFloat ox, ARFloat oy, ARFloat *ix, ARFloat *iy)
+{
+	if(!undistSparseTable)
+	{
+		buildUndistSparseTable(pCam);
+		if(!undistSparseTable)
+			return arParamObserv2Ideal_std(pCam, ox,oy, ix,iy);
+	}
+
+	ARFloat gx = ox / AR_UNDIST_SPARSE_STEP, gy = oy / AR_UNDIST_SPARSE_STEP;
+	ARFloat x00,y00, x10,y10, x01,y01, x11,y11;
+
+	if(gx<0)  gx = 0;
+	if(gy<0)  gy = 0;
+
+	int x = (int)gx, y = (int)gy;
+
+	if(x>undistSparseXsize-2)  x = undistSparseXsize-2;
+	if(y>undistSparseYsize-2)  y = undistSparseYsize-2;
+
+	const ARFloat fx = gx-x, fy = gy-y;
+	const ARUndistEntry* node = undistSparseTable + x + y*undistSparseXsize;
+
+	fixedToFloat(node[0], x00,y00);
+	fixedToFloat(node[1], x10,y10);
+	fixedToFloat(node[undistSparseXsize], x01,y01);
+	fixedToFloat(node[undistSparseXsize+1], x11,y11);
+
+	*ix = (1-fy)*((1-fx)*x00 + fx*x10) + fy*((1-fx)*x01 + fx*x11);
+	*iy = (1-fy)*((1-fx)*y00 + fx*y10) + fy*((1-fx)*y01 + fx*y11);
+	return 0;
+}
+
+
 AR_TEMPL_FUNC void
-AR_TEMPL_TRACKER::buildUndistO2ITable(Camera* pCam)
+AR_TEMPL_TRACKER::arParamObserv2IdealBatch(Camera* pCam, int nNum, const ARFloat* nOx, const ARFloat* nOy, ARFloat* nIx, ARFloat* nIy)
+{
+	int i;
+
+	// building a table may fall back to UNDIST_STD (see checkUndistTableRange())
+	if(undistMode==UNDIST_LUT && !undistO2ITable)
+		buildUndistO2ITable(pCam);
+	else if(undistMode==UNDIST_LUT_SPARSE && !undistSparseTable)
+		buildUndistSparseTable(pCam);
+
+	switch(undistMode)
+	{
+	case UNDIST_NONE:
+		for(i=0; i<nNum; i++)
+		{
+			nIx[i] = nOx[i];
+			nIy[i] = nOy[i];
+		}
+		break;
+
+	case UNDIST_STD:
+		pCam->observ2IdealBatch(nNum, nOx,nOy, nIx,nIy);
+		break;
+
+	case UNDIST_LUT:
+		for(i=0; i<nNum; i++)
+			arParamObserv2Ideal_LUT(pCam, nOx[i],nOy[i], nIx+i,nIy+i);
+		break;
+
+	case UNDIST_LUT_SPARSE:
+		for(i=0; i<nNum; i++)
+			arParamObserv2Ideal_LUTSparse(pCam, nOx[i],nOy[i], nIx+i,nIy+i);
+		break;
+	}
+}
+
+
+AR_TEMPL_FUNC void
+AR_TEMPL_TRACKER::freeUndistTables()
+{
+	freeUndistO2ITable();
+
+	if(undistSparseTable)
+		artkp_Free(undistSparseTable);
+	undistSparseTable = NULL;
+	undistSparseXsize = undistSparseYsize = 0;
+}
+
+
+AR_TEMPL_FUNC bool
+AR_TEMPL_TRACKER::checkUndistTableRange(Camera* pCam)
+{
+	int i;
+	ARFloat maxCoord = 0;
+
+	// radial distortion pushes the image border furthest out
+	for(i=0; i<=arImXsize+arImYsize; i+=8)
+	{
+		ARFloat ox = (ARFloat)(i<arImXsize ? i : arImXsize-1), oy = (ARFloat)(i<arImXsize ? 0 : i-arImXsize);
+		ARFloat cx,cy;
+
+		if(oy>arImYsize-1)
+			oy = (ARFloat)(arImYsize-1);
+
+		pCam->observ2Ideal(ox,oy, &cx,&cy);
+		if(fabs(cx)>maxCoord)  maxCoord = (ARFloat)fabs(cx);
+		if(fabs(cy)>maxCoord)  maxCoord = (ARFloat)fabs(cy);
+
+		pCam->observ2Ideal(arImXsize-1-ox,arImYsize-1-oy, &cx,&cy);
+		if(fabs(cx)>maxCoord)  maxCoord = (ARFloat)fabs(cx);
+		if(fabs(cy)>maxCoord)  maxCoord = (ARFloat)fabs(cy);
+	}
+
+	// the last nodes of the sparse table lie up to one step outside of the image
+	if(maxCoord+AR_UNDIST_SPARSE_STEP < ARUNDISTLUT_MAX_COORD)
+		return true;
+
+	if(logger)
+		logger->artLogEx("ARToolKitPlus: image too large for the undistortion table (build with AR_HIGH_RESOLUTION), using UNDIST_STD");
+	setUndistortionMode(UNDIST_STD);
+	return false;
+}
+
+
+AR_TEMPL_FUNC void
+AR_TEMPL_TRACKER::buildUndistSparseTable(Camera* pCam)
 {
 	int x,y;
-	ARFloat cx,cy, ox,oy;
-	unsigned int fixed;
-	char* cachename = NULL;
-	bool loaded = false;
+	ARFloat maxErr = 0;
+
+	if(undistSparseTable)
+		artkp_Free(undistSparseTable);
+	undistSparseTable = NULL;
+
+	if(!checkUndistTableRange(pCam))
+		return;
 
-	if(loadCachedUndist)
+	// the last row and column of nodes lie on or behind the last pixel
+	undistSparseXsize = (arImXsize-1)/AR_UNDIST_SPARSE_STEP + 2;
+	undistSparseYsize = (arImYsize-1)/AR_UNDIST_SPARSE_STEP + 2;
+	undistSparseTable = artkp_Alloc<ARUndistEntry>(undistSparseXsize*undistSparseYsize);
+
+#if defined(_OPENMP)
+	#pragma omp parallel for private(x) schedule(static)
+#endif
+	for(y=0; y<undistSparseYsize; y++)
 	{
-		assert(pCam->getFileName());
-		cachename = new char[strlen(pCam->getFileName())+5];
-		strcpy(cachename, pCam->getFileName());
-		strcat(cachename, ".LUT");
+		ARUndistEntry* row = undistSparseTable + y*undistSparseXsize;
+		ARFloat cx,cy;
+
+		for(x=0; x<undistSparseXsize; x++)
+		{
+			pCam->observ2Ideal((ARFloat)(x*AR_UNDIST_SPARSE_STEP), (ARFloat)(y*AR_UNDIST_SPARSE_STEP), &cx, &cy);
+			floatToFixed(cx,cy, row[x]);
+		}
+	}
+
+	// the interpolation error is largest in the middle of a cell
+	for(y=0; y<undistSparseYsize-1; y++)
+		for(x=0; x<undistSparseXsize-1; x++)
+		{
+			const ARFloat ox = (x+(ARFloat)0.5)*AR_UNDIST_SPARSE_STEP, oy = (y+(ARFloat)0.5)*AR_UNDIST_SPARSE_STEP;
+			ARFloat cx,cy, lx,ly;
+
+			pCam->observ2Ideal(ox,oy, &cx,&cy);
+			arParamObserv2Ideal_LUTSparse(pCam, ox,oy, &lx,&ly);
+			if(fabs(lx-cx)>maxErr)  maxErr = (ARFloat)fabs(lx-cx);
+			if(fabs(ly-cy)>maxErr)  maxErr = (ARFloat)fabs(ly-cy);
+		}
+
+	if(logger && maxErr>AR_UNDIST_SPARSE_MAX_ERROR)
+		logger->artLogEx("ARToolKitPlus: sparse undistortion table is off by up to %.3f pixels, consider UNDIST_LUT", maxErr);
+}
+
+
+AR_TEMPL_FUNC void
+AR_TEMPL_TRACKER::freeUndistO2ITable()
+{
+	// a table loaded from the cache is only mapped
+	if(undistLUTFile.isOpen())
+		undistLUTFile.close();
+	else if(undistO2ITable)
+		artkp_Free(undistO2ITable);
+
+	undistO2ITable = NULL;
+}
+
+
+AR_TEMPL_FUNC ARUint32
+AR_TEMPL_TRACKER::hashUndistortion(Camera* pCam)
+{
+	const int n = 16;
+	ARUint32 hash = 2166136261u;				// FNV-1a
+	ARFloat v[2];
+	int i, j, k;
+
+	ARUint32 size[2] = { (ARUint32)arImXsize, (ARUint32)arImYsize };
+	for(k=0; k<(int)sizeof(size); k++)
+		hash = (hash ^ ((const ARUint8*)size)[k]) * 16777619u;
+
+	// the undistorted positions of a grid of image points identify the camera model
+	for(j=0; j<=n; j++)
+		for(i=0; i<=n; i++)
+		{
+			pCam->observ2Ideal((ARFloat)(i*(arImXsize-1))/n, (ARFloat)(j*(arImYsize-1))/n, &v[0], &v[1]);
+			for(k=0; k<(int)sizeof(v); k++)
+				hash = (hash ^ ((const ARUint8*)v)[k]) * 16777619u;
+		}
+
+	return hash;
+}
+
+
+AR_TEMPL_FUNC bool
+AR_TEMPL_TRACKER::loadUndistLUTCache(const char* nFileName, ARUint32 nHash)
+{
+	const ARUndistLUTHeader *header;
+
+	if(!undistLUTFile.open(nFileName))
+		return false;
+
+	header = (const ARUndistLUTHeader*)undistLUTFile.getData();
+
+	if(undistLUTFile.getSize() != sizeof(ARUndistLUTHeader) + arImXsize*arImYsize*sizeof(ARUndistEntry) ||
+	   memcmp(header->magic, "ALUT", 4) != 0 || header->version != ARUNDISTLUT_VERSION ||
+	   header->byteOrder != ARUNDISTLUT_BYTEORDER || header->encoding != ARUNDISTLUT_ENCODING ||
+	   header->xsize != (ARUint32)arImXsize || header->ysize != (ARUint32)arImYsize || header->paramHash != nHash)
+	{
+		undistLUTFile.close();
+		if(logger)
+			logger->artLogEx("ARToolKitPlus: undistortion cache '%s' does not match the camera, rebuilding it", nFileName);
+		return false;
 	}
 
+	// the mapping is read-only, the table is never written once built
+	undistO2ITable = (ARUndistEntry*)(undistLUTFile.getData() + sizeof(ARUndistLUTHeader));
+	return true;
+}
+
+
+AR_TEMPL_FUNC bool
+AR_TEMPL_TRACKER::saveUndistLUTCache(const char* nFileName, ARUint32 nHash)
+{
+	ARUndistLUTHeader header;
+	size_t numEntries = (size_t)arImXsize*arImYsize;
+	char* tmpname;
+	bool ok = false;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, "ALUT", 4);
+	header.version = ARUNDISTLUT_VERSION;
+	header.byteOrder = ARUNDISTLUT_BYTEORDER;
+	header.encoding = ARUNDISTLUT_ENCODING;
+	header.xsize = arImXsize;
+	header.ysize = arImYsize;
+	header.paramHash = nHash;
+
+	// other processes might be mapping the old cache or building their own:
+	// write a private file and replace the cache in one step
+	tmpname = MappedFile::createTempFileName(nFileName, this);
+
+	if(FILE* fp = fopen(tmpname, "wb"))
+	{
+		ok = fwrite(&header, sizeof(header), 1, fp)==1 &&
+			 fwrite(undistO2ITable, sizeof(ARUndistEntry), numEntries, fp)==numEntries;
+		ok = (fclose(fp)==0) && ok;
+
+		if(ok && rename(tmpname, nFileName)!=0)
+		{
+			// rename() does not replace existing files on every platform
+			remove(nFileName);
+			ok = rename(tmpname, nFileName)==0;
+		}
+
+		if(!ok)
+			remove(tmpname);
+	}
+
+	if(!ok && logger)
+		logger->artLogEx("ARToolKitPlus: failed to write undistortion cache '%s'", nFileName);
+
+	delete [] tmpname;
+	return ok;
+}
+
+
+AR_TEMPL_FUNC void
+AR_TEMPL_TRACKER::buildUndistO2ITable(Camera* pCam)
+{
+	int x,y;
+	char* cachename = NULL;
+	ARUint32 hash = 0;
+
 	// we have to take care here when using a memory manager that can not free memory
 	// (usually this lookup table should only be built once - unless we change camera resolution)
 	//
-	if(undistO2ITable)
-		//delete undistO2ITable;
-		artkp_Free(undistO2ITable);
+	freeUndistO2ITable();
 
-	//undistO2ITable = new unsigned int [arImXsize*arImYsize];
-	undistO2ITable = artkp_Alloc<unsigned int>(arImXsize*arImYsize);
+	if(!checkUndistTableRange(pCam))
+		return;
 
-	if(loadCachedUndist)
+	if(loadCachedUndist && pCam->getFileName())
 	{
-		if(FILE* fp = fopen(cachename, "rb"))
-		{
-			size_t numBytes = fread(undistO2ITable, 1, arImXsize*arImYsize*sizeof(unsigned int), fp);
-			fclose(fp);
+		cachename = new char[strlen(pCam->getFileName())+5];
+		strcpy(cachename, pCam->getFileName());
+		strcat(cachename, ".LUT");
 
-			if(numBytes == arImXsize*arImYsize*sizeof(unsigned int))
-				loaded = true;
+		hash = hashUndistortion(pCam);
+		if(loadUndistLUTCache(cachename, hash))
+		{
+			delete [] cachename;
+			return;
 		}
 	}
 
-	if(!loaded)
+	//undistO2ITable = new ARUndistEntry[arImXsize*arImYsize];
+	undistO2ITable = artkp_Alloc<ARUndistEntry>(arImXsize*arImYsize);
+
+	// rows are independent, so they are filled in parallel and
+	// every thread writes a contiguous block of the table
+#if defined(_OPENMP)
+	#pragma omp parallel for private(x) schedule(static)
+#endif
+	for(y=0; y<arImYsize; y++)
 	{
+		ARUndistEntry* row = undistO2ITable + y*arImXsize;
+		ARFloat cx,cy;
+
 		for(x=0; x<arImXsize; x++)
 		{
-			for(y=0; y<arImYsize; y++)
-			{
-				arParamObserv2Ideal_std(pCam, (ARFloat)x, (ARFloat)y, &cx, &cy);
-				floatToFixed(cx,cy, fixed);
-				fixedToFloat(fixed, ox,oy);
-				undistO2ITable[x+y*arImXsize] = fixed;
-			}
+			pCam->observ2Ideal((ARFloat)x, (ARFloat)y, &cx, &cy);
+			floatToFixed(cx,cy, row[x]);
 		}
+	}
 
-		if(loadCachedUndist)
-			if(FILE* fp = fopen(cachename, "wb"))
-			{
-				fwrite(undistO2ITable, 1, arImXsize*arImYsize*sizeof(unsigned int), fp);
-				fclose(fp);
-			}
+	// use the mapped cache from now on, so all trackers on this machine share one copy
+	if(cachename && saveUndistLUTCache(cachename, hash))
+	{
+		ARUndistEntry* table = undistO2ITable;
+		if(loadUndistLUTCache(cachename, hash))
+			artkp_Free(table);
+		else
+			undistO2ITable = table;
 	}
 
-	delete cachename;
+	delete [] cachename;
 }
 
 
@@ -50,20 +50,61 @@ namespace ARToolKitPlus {
 
 AR_TEMPL_FUNC ARFloat
 AR_TEMPL_TRACKER::rppGetTransMat(ARMarkerInfo *marker_info, ARFloat center[2], ARFloat width, ARFloat conv[3][4])
+{
+	return rppGetTransMatSub(marker_info, NULL, center, width, conv);
+}
+
+
+AR_TEMPL_FUNC ARFloat
+AR_TEMPL_TRACKER::rppGetTransMatCont(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat center[2], ARFloat width, ARFloat conv[3][4])
+{
+	ARFloat err1, err2;
+	ARFloat wtrans[3][4];
+
+	err1 = rppGetTransMatSub(marker_info, prev_conv, center, width, conv);
+	if(err1 < 0 || err1 > AR_GET_TRANS_RPP_CONT_MAX_FIT_ERROR)
+	{
+		err2 = rppGetTransMatSub(marker_info, NULL, center, width, wtrans);
+		if(err2 >= 0 && (err1 < 0 || err2 < err1))
+		{
+			for(int j=0; j<3; j++)
+				for(int i=0; i<4; i++)
+					conv[j][i] = wtrans[j][i];
+			err1 = err2;
+		}
+	}
+
+	return err1;
+}
+
+
+// prev_conv==NULL: RPP estimates the initial rotation itself
+//
+AR_TEMPL_FUNC ARFloat
+AR_TEMPL_TRACKER::rppGetTransMatSub(ARMarkerInfo *marker_info, ARFloat prev_conv[3][4], ARFloat center[2], ARFloat width, ARFloat conv[3][4])
 {
 	const bool initial_estimate_with_arGetInitRot = false; // only for testing
-	
+	bool estimate_R_init = true;
+
 	rpp_float err = 1e+20;
 	rpp_mat R, R_init;
 	rpp_vec t;
 
-	if(initial_estimate_with_arGetInitRot )
+	if(prev_conv)
+	{
+		for(int i=0; i<3; i++)
+			for(int j=0; j<3; j++)
+				R_init[i][j] = (rpp_float)prev_conv[i][j];
+		estimate_R_init = false;
+	}
+	else if(initial_estimate_with_arGetInitRot )
 	{
 		ARFloat  rot[3][3];
 		if( arGetInitRot( marker_info, arCamera->mat, rot ) < 0 ) return -1;
 		for(int i=0; i<3; i++)
 			for(int j=0; j<3; j++)
 				R_init[i][j] = (rpp_float)rot[i][j];
+		estimate_R_init = false;
 	}
 
 	int dir = marker_info->dir;
@@ -102,7 +143,7 @@ AR_TEMPL_TRACKER::rppGetTransMat(ARMarkerInfo *marker_info, ARFloat center[2], A
 	const rpp_float cc[2] = {arCamera->mat[0][2],arCamera->mat[1][2]};
 	const rpp_float fc[2] = {arCamera->mat[0][0],arCamera->mat[1][1]};
 
-	robustPlanarPose(err,R,t,cc,fc,ppos3d,ppos2d,n_pts,R_init, !initial_estimate_with_arGetInitRot,0,0,0);
+	robustPlanarPoseFixed(err,R,t,cc,fc,ppos3d,ppos2d,n_pts,R_init, estimate_R_init,0,0,0);
 
 	for(int i=0; i<3; i++)
 	{
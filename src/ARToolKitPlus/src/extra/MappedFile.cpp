@@ -0,0 +1,213 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+#include <ARToolKitPlus/extra/MappedFile.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_MSC_VER) && !defined(_WIN32_WCE)
+#  define _ARTKP_USE_MMAP_
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#elif defined(_WIN32_WCE)
+#  include <windows.h>
+#endif
+
+
+namespace ARToolKitPlus {
+
+
+MappedFile::MappedFile()
+{
+	data = NULL;
+	size = 0;
+	mapped = false;
+
+#if defined(_MSC_VER) && !defined(_WIN32_WCE)
+	hFile = INVALID_HANDLE_VALUE;
+	hMapObject = NULL;
+#endif
+}
+
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+
+bool
+MappedFile::open(const char* nFileName)
+{
+	close();
+
+	if(!nFileName)
+		return false;
+
+#if defined(_MSC_VER) && !defined(_WIN32_WCE)
+	hFile = CreateFileA(nFileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(hFile==INVALID_HANDLE_VALUE)
+		return false;
+
+	DWORD sizeHigh = 0;
+	DWORD sizeLow = GetFileSize(hFile, &sizeHigh);
+	if(sizeLow==0 && sizeHigh==0)
+	{
+		close();
+		return false;
+	}
+
+	hMapObject = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(hMapObject==NULL)
+	{
+		close();
+		return false;
+	}
+
+	data = (unsigned char*)MapViewOfFile(hMapObject, FILE_MAP_READ, 0, 0, 0);
+	if(data==NULL)
+	{
+		close();
+		return false;
+	}
+
+	size = (size_t)sizeLow;
+	mapped = true;
+	return true;
+
+#elif defined(_ARTKP_USE_MMAP_)
+	int fd = ::open(nFileName, O_RDONLY);
+	if(fd<0)
+		return false;
+
+	struct stat st;
+	if(fstat(fd, &st)!=0 || st.st_size<=0)
+	{
+		::close(fd);
+		return false;
+	}
+
+	void* ptr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);									// the mapping stays valid after closing the descriptor
+
+	if(ptr==MAP_FAILED)
+		return false;
+
+	data = (unsigned char*)ptr;
+	size = (size_t)st.st_size;
+	mapped = true;
+	return true;
+
+#else
+	FILE* fp = fopen(nFileName, "rb");
+	if(!fp)
+		return false;
+
+	fseek(fp, 0, SEEK_END);
+	long len = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	if(len>0 && (data = (unsigned char*)malloc(len))!=NULL)
+	{
+		if(fread(data, 1, len, fp)==(size_t)len)
+			size = (size_t)len;
+		else
+		{
+			free(data);
+			data = NULL;
+		}
+	}
+
+	fclose(fp);
+	mapped = false;
+	return data!=NULL;
+#endif
+}
+
+
+void
+MappedFile::close()
+{
+#if defined(_MSC_VER) && !defined(_WIN32_WCE)
+	if(data)
+		UnmapViewOfFile(data);
+	if(hMapObject)
+		CloseHandle(hMapObject);
+	if(hFile!=INVALID_HANDLE_VALUE)
+		CloseHandle(hFile);
+	hMapObject = NULL;
+	hFile = INVALID_HANDLE_VALUE;
+#else
+	if(data)
+	{
+#  ifdef _ARTKP_USE_MMAP_
+		if(mapped)
+			munmap(data, size);
+		else
+#  endif
+			free(data);
+	}
+#endif
+
+	data = NULL;
+	size = 0;
+	mapped = false;
+}
+
+
+char*
+MappedFile::createTempFileName(const char* nFileName, const void* nOwner)
+{
+	char* name = new char[strlen(nFileName)+64];
+
+#if defined(_MSC_VER) || defined(_WIN32_WCE)
+	unsigned long pid = (unsigned long)GetCurrentProcessId();
+#else
+	unsigned long pid = (unsigned long)getpid();
+#endif
+
+	sprintf(name, "%s.%lu.%p.tmp", nFileName, pid, nOwner);
+	return name;
+}
+
+
+}  // namespace ARToolKitPlus
@@ -0,0 +1,491 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+#include <ARToolKitPlus/extra/MarkerDictionary.h>
+#include <stdio.h>
+#include <string.h>
+
+
+namespace ARToolKitPlus {
+
+
+MarkerDictionary::MarkerDictionary()
+{
+	gridSize = 0;
+	minDistance = 1;
+	indexMask = 0;
+	indexRadius = 0;
+}
+
+
+_64bits
+MarkerDictionary::rotate90CW(_64bits nCode, int nGridSize)
+{
+	const int numBits = nGridSize*nGridSize;
+	const _64bits one = 1;
+	_64bits res = 0;
+	int r,c;
+
+	// cell (r,c) of the rotated grid is cell (nGridSize-1-c,r) of the original.
+	// cell p is stored in bit numBits-1-p.
+	//
+	for(r=0; r<nGridSize; r++)
+		for(c=0; c<nGridSize; c++)
+		{
+			int src = (nGridSize-1-c)*nGridSize + r,
+				dst = r*nGridSize + c;
+
+			if((nCode>>(numBits-1-src))&1)
+				res |= one<<(numBits-1-dst);
+		}
+
+	return res;
+}
+
+
+int
+MarkerDictionary::hammingDistance(_64bits nCode0, _64bits nCode1)
+{
+	_64bits diff = nCode0^nCode1;
+
+#if defined(__GNUC__)
+	return __builtin_popcountll(diff);
+#else
+	int cnt = 0;
+
+	while(diff)
+	{
+		diff &= diff-1;
+		cnt++;
+	}
+
+	return cnt;
+#endif
+}
+
+
+int
+MarkerDictionary::distanceToDictionary(_64bits nCode) const
+{
+	int best = gridSize*gridSize;
+
+	for(size_t i=0; i<rotated.size(); i++)
+	{
+		int dist = hammingDistance(nCode, rotated[i]);
+		if(dist<best)
+			best = dist;
+	}
+
+	return best;
+}
+
+
+bool
+MarkerDictionary::addCode(_64bits nCode)
+{
+	_64bits rot[4];
+	int i,j;
+
+	rot[0] = nCode;
+	for(i=1; i<4; i++)
+		rot[i] = rotate90CW(rot[i-1], gridSize);
+
+	// the rotations of a marker must be distinguishable too,
+	// otherwise the marker's orientation is ambiguous
+	//
+	for(i=0; i<4; i++)
+		for(j=i+1; j<4; j++)
+			if(hammingDistance(rot[i], rot[j])<minDistance)
+				return false;
+
+	if(distanceToDictionary(nCode)<minDistance)
+		return false;
+
+	// rotated[id*4+dir] is the code as it is read after the marker was
+	// rotated dir times CCW, which in turn requires dir CW rotations to
+	// turn it upright again. this matches the direction convention of arGetCode().
+	//
+	codes.push_back(nCode);
+	rotated.push_back(rot[0]);
+	rotated.push_back(rot[3]);
+	rotated.push_back(rot[2]);
+	rotated.push_back(rot[1]);
+
+	return true;
+}
+
+
+int
+MarkerDictionary::generate(int nGridSize, int nNumMarkers, int nMinDistance, unsigned int nSeed)
+{
+	if(nGridSize<DICTIONARY_MIN_GRID || nGridSize>DICTIONARY_MAX_GRID || nMinDistance<1)
+		return 0;
+
+	gridSize = nGridSize;
+	minDistance = nMinDistance;
+	codes.clear();
+	rotated.clear();
+
+	const int numBits = gridSize*gridSize;
+	const _64bits mask = (((_64bits)1)<<numBits)-1;
+	const _64bits mul = (((_64bits)0x5851F42D)<<32) | 0x4C957F2D,
+				  inc = (((_64bits)0x14057B7E)<<32) | 0xF767814F;
+	_64bits rnd = nSeed;
+	int failed = 0;
+
+	// greedily add random codes. stop if no new marker can be
+	// found for a long time since the code space is exhausted.
+	//
+	while((int)codes.size()<nNumMarkers && failed<10000)
+	{
+		rnd = rnd*mul + inc;
+		_64bits code = (rnd>>(64-numBits)) & mask;
+
+		if(addCode(code))
+			failed = 0;
+		else
+			failed++;
+	}
+
+	buildIndex();
+
+	return (int)codes.size();
+}
+
+
+bool
+MarkerDictionary::load(const char* nFileName)
+{
+	FILE* fp = fopen(nFileName, "r");
+	char line[256];
+	int numMarkers = 0, loaded = 0;
+
+	if(fp==NULL)
+		return false;
+
+	// parse into a separate dictionary, so that
+	// a broken file leaves this one untouched
+	//
+	MarkerDictionary dict;
+
+	while(fgets(line, sizeof(line), fp))
+	{
+		if(line[0]=='#' || line[0]=='\n' || line[0]=='\r')
+			continue;
+
+		if(dict.gridSize==0)
+		{
+			if(sscanf(line, "%d %d %d", &dict.gridSize, &numMarkers, &dict.minDistance)!=3 ||
+			   dict.gridSize<DICTIONARY_MIN_GRID || dict.gridSize>DICTIONARY_MAX_GRID || dict.minDistance<1)
+			{
+				dict.gridSize = 0;
+				break;
+			}
+			continue;
+		}
+
+		const int numBits = dict.gridSize*dict.gridSize;
+		_64bits code = 0;
+		int i;
+
+		for(i=0; i<numBits && (line[i]=='0' || line[i]=='1'); i++)
+			code = (code<<1) | (line[i]=='1' ? 1 : 0);
+
+		// invalid lines and markers that violate the minimum
+		// distance make the whole dictionary invalid
+		//
+		if(i<numBits || !dict.addCode(code))
+			break;
+
+		if(++loaded==numMarkers)
+			break;
+	}
+
+	fclose(fp);
+
+	if(dict.gridSize==0 || loaded==0 || loaded!=numMarkers)
+		return false;
+
+	dict.buildIndex();
+	*this = dict;
+	return true;
+}
+
+
+bool
+MarkerDictionary::save(const char* nFileName) const
+{
+	FILE* fp = fopen(nFileName, "w");
+
+	if(fp==NULL)
+		return false;
+
+	const int numBits = gridSize*gridSize;
+
+	fprintf(fp, "# ARToolKitPlus marker dictionary: grid size, number of markers, minimum distance\n");
+	fprintf(fp, "%d %d %d\n", gridSize, (int)codes.size(), minDistance);
+
+	for(size_t i=0; i<codes.size(); i++)
+	{
+		for(int b=numBits-1; b>=0; b--)
+			fputc(((codes[i]>>b)&1) ? '1' : '0', fp);
+		fputc('\n', fp);
+	}
+
+	fclose(fp);
+	return true;
+}
+
+
+bool
+MarkerDictionary::getCode(int nId, _64bits& nCode) const
+{
+	if(nId<0 || nId>=(int)codes.size())
+		return false;
+
+	nCode = codes[nId];
+	return true;
+}
+
+
+static unsigned int
+hashCode(_64bits nCode)
+{
+	const _64bits golden = (((_64bits)0x9E3779B9)<<32) | 0x7F4A7C15;
+	return (unsigned int)((nCode*golden)>>32);
+}
+
+
+void
+MarkerDictionary::addToIndex(_64bits nCode, int nValue)
+{
+	unsigned int slot = hashCode(nCode) & indexMask;
+
+	while(indexValues[slot]!=-1)
+		slot = (slot+1) & indexMask;
+
+	indexKeys[slot] = nCode;
+	indexValues[slot] = nValue;
+}
+
+
+int
+MarkerDictionary::findInIndex(_64bits nCode) const
+{
+	if(indexValues.empty())
+		return -1;
+
+	unsigned int slot = hashCode(nCode) & indexMask;
+
+	while(indexValues[slot]!=-1)
+	{
+		if(indexKeys[slot]==nCode)
+			return indexValues[slot];
+		slot = (slot+1) & indexMask;
+	}
+
+	return -1;
+}
+
+
+// number of codes with up to nNumErrors of nNumBits bits flipped
+static size_t
+numCodesWithErrors(int nNumBits, int nNumErrors)
+{
+	size_t num = 1, binom = 1;
+
+	for(int k=1; k<=nNumErrors; k++)
+	{
+		binom = binom * (nNumBits-k+1) / k;
+		num += binom;
+	}
+
+	return num;
+}
+
+
+void
+MarkerDictionary::addToIndexWithErrors(_64bits nCode, int nValue, int nFirstBit, int nNumErrors)
+{
+	const int numBits = gridSize*gridSize;
+
+	for(int b=nFirstBit; b<numBits; b++)
+	{
+		_64bits code = nCode^(((_64bits)1)<<b);
+
+		addToIndex(code, nValue);
+		if(nNumErrors>1)
+			addToIndexWithErrors(code, nValue, b+1, nNumErrors-1);
+	}
+}
+
+
+void
+MarkerDictionary::buildChunkIndex()
+{
+	const int numBits = gridSize*gridSize;
+	const int maxCorrection = getMaxCorrection();
+	int c, numChunks, numBuckets = 0;
+	size_t i;
+
+	chunkLow.clear();
+	chunkBits.clear();
+	chunkOffset.clear();
+	bucketStart.clear();
+	bucketEntries.clear();
+
+	if(maxCorrection<=indexRadius || rotated.empty())
+		return;
+
+	// with maxCorrection wrong bits at least one of maxCorrection+1
+	// disjoint chunks is still correct. more chunks keep them small.
+	//
+	numChunks = maxCorrection+1;
+	while((numBits+numChunks-1)/numChunks > DICTIONARY_MAX_CHUNK_BITS)
+		numChunks++;
+	if(numChunks>numBits)
+		numChunks = numBits;
+
+	for(c=0; c<numChunks; c++)
+	{
+		chunkLow.push_back(c*numBits/numChunks);
+		chunkBits.push_back((c+1)*numBits/numChunks - chunkLow[c]);
+		chunkOffset.push_back(numBuckets);
+		numBuckets += 1<<chunkBits[c];
+	}
+
+	// sort all rotated codes into the buckets of their chunk values
+	//
+	bucketStart.assign(numBuckets+1, 0);
+	bucketEntries.resize(rotated.size()*numChunks);
+
+	for(i=0; i<rotated.size(); i++)
+		for(c=0; c<numChunks; c++)
+			bucketStart[chunkOffset[c] + (int)((rotated[i]>>chunkLow[c]) & ((1<<chunkBits[c])-1)) + 1]++;
+
+	for(c=0; c<numBuckets; c++)
+		bucketStart[c+1] += bucketStart[c];
+
+	std::vector<int> fill(bucketStart.begin(), bucketStart.end()-1);
+
+	for(i=0; i<rotated.size(); i++)
+		for(c=0; c<numChunks; c++)
+			bucketEntries[fill[chunkOffset[c] + (int)((rotated[i]>>chunkLow[c]) & ((1<<chunkBits[c])-1))]++] = (int)i;
+}
+
+
+int
+MarkerDictionary::findInChunkIndex(_64bits nCode) const
+{
+	const int maxCorrection = getMaxCorrection();
+
+	for(size_t c=0; c<chunkLow.size(); c++)
+	{
+		int b = chunkOffset[c] + (int)((nCode>>chunkLow[c]) & ((1<<chunkBits[c])-1));
+
+		for(int e=bucketStart[b]; e<bucketStart[b+1]; e++)
+			if(hammingDistance(nCode, rotated[bucketEntries[e]])<=maxCorrection)
+				return bucketEntries[e];
+	}
+
+	return -1;
+}
+
+
+void
+MarkerDictionary::buildIndex()
+{
+	const int numBits = gridSize*gridSize;
+	const int maxCorrection = getMaxCorrection();
+	size_t tableSize = 16;
+
+	// index as many wrong bits as the size limit allows. a radius up
+	// to getMaxCorrection() guarantees that all entries are unique.
+	//
+	indexRadius = 0;
+	while(indexRadius<maxCorrection &&
+		  rotated.size()*numCodesWithErrors(numBits, indexRadius+1)<=DICTIONARY_MAX_INDEX_ENTRIES)
+		indexRadius++;
+
+	// keep the table at most half full
+	//
+	while(tableSize<2*rotated.size()*numCodesWithErrors(numBits, indexRadius))
+		tableSize *= 2;
+
+	indexKeys.assign(tableSize, 0);
+	indexValues.assign(tableSize, -1);
+	indexMask = (unsigned int)tableSize-1;
+
+	for(size_t i=0; i<rotated.size(); i++)
+	{
+		addToIndex(rotated[i], (int)i);
+
+		if(indexRadius>0)
+			addToIndexWithErrors(rotated[i], (int)i, 0, indexRadius);
+	}
+
+	buildChunkIndex();
+}
+
+
+int
+MarkerDictionary::decode(_64bits nCode, int& nDir, int& nDistance) const
+{
+	const int maxCorrection = getMaxCorrection();
+	int idx = findInIndex(nCode);
+
+	// more errors than the index covers
+	//
+	if(idx<0 && maxCorrection>indexRadius)
+		idx = findInChunkIndex(nCode);
+
+	if(idx<0)
+	{
+		nDir = 0;
+		nDistance = gridSize*gridSize;
+		return -1;
+	}
+
+	nDir = idx&3;
+	nDistance = hammingDistance(nCode, rotated[idx]);
+	return idx>>2;
+}
+
+
+}  // namespace ARToolKitPlus
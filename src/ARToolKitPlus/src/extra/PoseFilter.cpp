@@ -0,0 +1,359 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+#include <ARToolKitPlus/extra/PoseFilter.h>
+#include <math.h>
+#include <stddef.h>
+
+
+namespace ARToolKitPlus {
+
+
+static void
+quatFromMatrix(const ARFloat m[3][4], ARFloat q[4])
+{
+	ARFloat tr = m[0][0] + m[1][1] + m[2][2], s;
+
+	if(tr > 0)
+	{
+		s = (ARFloat)sqrt(tr + 1.0) * 2;
+		q[0] = s / 4;
+		q[1] = (m[2][1] - m[1][2]) / s;
+		q[2] = (m[0][2] - m[2][0]) / s;
+		q[3] = (m[1][0] - m[0][1]) / s;
+	}
+	else if(m[0][0] > m[1][1] && m[0][0] > m[2][2])
+	{
+		s = (ARFloat)sqrt(1.0 + m[0][0] - m[1][1] - m[2][2]) * 2;
+		q[0] = (m[2][1] - m[1][2]) / s;
+		q[1] = s / 4;
+		q[2] = (m[0][1] + m[1][0]) / s;
+		q[3] = (m[0][2] + m[2][0]) / s;
+	}
+	else if(m[1][1] > m[2][2])
+	{
+		s = (ARFloat)sqrt(1.0 + m[1][1] - m[0][0] - m[2][2]) * 2;
+		q[0] = (m[0][2] - m[2][0]) / s;
+		q[1] = (m[0][1] + m[1][0]) / s;
+		q[2] = s / 4;
+		q[3] = (m[1][2] + m[2][1]) / s;
+	}
+	else
+	{
+		s = (ARFloat)sqrt(1.0 + m[2][2] - m[0][0] - m[1][1]) * 2;
+		q[0] = (m[1][0] - m[0][1]) / s;
+		q[1] = (m[0][2] + m[2][0]) / s;
+		q[2] = (m[1][2] + m[2][1]) / s;
+		q[3] = s / 4;
+	}
+
+	s = (ARFloat)sqrt(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+	for(int i=0; i<4; i++)
+		q[i] /= s;
+}
+
+
+static void
+matrixFromQuat(const ARFloat q[4], ARFloat m[3][4])
+{
+	const ARFloat w = q[0], x = q[1], y = q[2], z = q[3];
+
+	m[0][0] = 1 - 2*(y*y + z*z);  m[0][1] = 2*(x*y - w*z);      m[0][2] = 2*(x*z + w*y);
+	m[1][0] = 2*(x*y + w*z);      m[1][1] = 1 - 2*(x*x + z*z);  m[1][2] = 2*(y*z - w*x);
+	m[2][0] = 2*(x*z - w*y);      m[2][1] = 2*(y*z + w*x);      m[2][2] = 1 - 2*(x*x + y*y);
+}
+
+
+// r = a * b
+static void
+quatMul(const ARFloat a[4], const ARFloat b[4], ARFloat r[4])
+{
+	ARFloat t[4];
+
+	t[0] = a[0]*b[0] - a[1]*b[1] - a[2]*b[2] - a[3]*b[3];
+	t[1] = a[0]*b[1] + a[1]*b[0] + a[2]*b[3] - a[3]*b[2];
+	t[2] = a[0]*b[2] - a[1]*b[3] + a[2]*b[0] + a[3]*b[1];
+	t[3] = a[0]*b[3] + a[1]*b[2] - a[2]*b[1] + a[3]*b[0];
+
+	r[0] = t[0];  r[1] = t[1];  r[2] = t[2];  r[3] = t[3];
+}
+
+
+// quaternion of the rotation by |v| radians around v
+static void
+quatExp(const ARFloat v[3], ARFloat q[4])
+{
+	ARFloat angle = (ARFloat)sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]), s;
+
+	if(angle < 1e-8)
+	{
+		q[0] = 1;
+		q[1] = v[0]/2;  q[2] = v[1]/2;  q[3] = v[2]/2;
+		return;
+	}
+
+	s = (ARFloat)sin(angle/2) / angle;
+	q[0] = (ARFloat)cos(angle/2);
+	q[1] = v[0]*s;  q[2] = v[1]*s;  q[3] = v[2]*s;
+}
+
+
+// inverse of quatExp(), takes the shorter way
+static void
+quatLog(const ARFloat q[4], ARFloat v[3])
+{
+	ARFloat sign = q[0] < 0 ? (ARFloat)-1 : (ARFloat)1;
+	ARFloat len = (ARFloat)sqrt(q[1]*q[1] + q[2]*q[2] + q[3]*q[3]), s;
+
+	if(len < 1e-8)
+		s = 2*sign;
+	else
+		s = 2*(ARFloat)atan2(len, sign*q[0]) * sign / len;
+
+	v[0] = q[1]*s;  v[1] = q[2]*s;  v[2] = q[3]*s;
+}
+
+
+static void
+quatNormalize(ARFloat q[4])
+{
+	ARFloat len = (ARFloat)sqrt(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+
+	for(int i=0; i<4; i++)
+		q[i] /= len;
+}
+
+
+PoseFilter::PoseFilter()
+{
+	alpha = (ARFloat)AR_POSE_FILTER_ALPHA;
+	beta = (ARFloat)AR_POSE_FILTER_BETA;
+	maxGap = AR_POSE_FILTER_MAX_GAP;
+	reset();
+}
+
+
+void
+PoseFilter::setGains(ARFloat nAlpha, ARFloat nBeta)
+{
+	alpha = nAlpha>0 ? (nAlpha<=1 ? nAlpha : 1) : (ARFloat)AR_POSE_FILTER_ALPHA;
+	beta = nBeta>=0 ? (nBeta<2 ? nBeta : (ARFloat)1.9) : (ARFloat)AR_POSE_FILTER_BETA;
+}
+
+
+void
+PoseFilter::reset()
+{
+	numTargets = 0;
+}
+
+
+void
+PoseFilter::remove(int nId)
+{
+	for(int i=0; i<numTargets; i++)
+		if(targets[i].id==nId)
+		{
+			targets[i] = targets[--numTargets];
+			return;
+		}
+}
+
+
+const PoseFilter::Target*
+PoseFilter::findTarget(int nId) const
+{
+	for(int i=0; i<numTargets; i++)
+		if(targets[i].id==nId)
+			return &targets[i];
+
+	return NULL;
+}
+
+
+void
+PoseFilter::predict(const Target& nTarget, ARFloat nDt, ARFloat nPos[3], ARFloat nQuat[4])
+{
+	ARFloat rot[3];
+	int i;
+
+	for(i=0; i<3; i++)
+	{
+		nPos[i] = nTarget.pos[i] + nTarget.vel[i]*nDt;
+		rot[i] = nTarget.angVel[i]*nDt;
+	}
+
+	quatExp(rot, nQuat);
+	quatMul(nQuat, nTarget.quat, nQuat);
+	quatNormalize(nQuat);
+}
+
+
+void
+PoseFilter::update(int nId, double nTime, const ARFloat nTrans[3][4], ARFloat nRadius, const ARFloat nCenter[3])
+{
+	Target* t = const_cast<Target*>(findTarget(nId));
+	ARFloat quat[4], predQuat[4], predPos[3], err[3], delta[4], dt;
+	bool restart = false;
+	int i;
+
+	if(!t)
+	{
+		// take a free slot or else the one updated least recently
+		if(numTargets<AR_POSE_FILTER_MAX_TARGETS)
+			t = &targets[numTargets++];
+		else
+		{
+			t = &targets[0];
+			for(i=1; i<numTargets; i++)
+				if(targets[i].time<t->time)
+					t = &targets[i];
+		}
+		t->id = nId;
+		restart = true;
+	}
+
+	t->radius = nRadius;
+	for(i=0; i<3; i++)
+		t->center[i] = nCenter ? nCenter[i] : 0;
+
+	quatFromMatrix(nTrans, quat);
+	dt = (ARFloat)(nTime - t->time);
+
+	if(restart || dt > maxGap)
+	{
+		// new or lost for too long: start at rest
+		for(i=0; i<3; i++)
+		{
+			t->pos[i] = nTrans[i][3];
+			t->vel[i] = t->angVel[i] = 0;
+		}
+		for(i=0; i<4; i++)
+			t->quat[i] = quat[i];
+		t->time = nTime;
+		return;
+	}
+
+	// a second measurement for the same time only corrects the pose
+	if(dt < 0)
+		dt = 0;
+
+	predict(*t, dt, predPos, predQuat);
+
+	for(i=0; i<3; i++)
+	{
+		err[i] = nTrans[i][3] - predPos[i];
+		t->pos[i] = predPos[i] + alpha*err[i];
+		if(dt > 0)
+			t->vel[i] += beta/dt*err[i];
+	}
+
+	// rotational residual as a rotation vector in camera coordinates
+	t->quat[0] = predQuat[0];
+	for(i=1; i<4; i++)
+		t->quat[i] = -predQuat[i];
+	quatMul(quat, t->quat, delta);
+	quatLog(delta, err);
+
+	for(i=0; i<3; i++)
+	{
+		if(dt > 0)
+			t->angVel[i] += beta/dt*err[i];
+		err[i] *= alpha;
+	}
+
+	quatExp(err, delta);
+	quatMul(delta, predQuat, t->quat);
+	quatNormalize(t->quat);
+
+	if(dt > 0)
+		t->time = nTime;
+}
+
+
+bool
+PoseFilter::getPose(int nId, double nTime, ARFloat nTrans[3][4]) const
+{
+	const Target* t = findTarget(nId);
+	ARFloat pos[3], quat[4];
+	double dt;
+
+	if(!t)
+		return false;
+
+	dt = nTime - t->time;
+	if(dt > maxGap)
+		return false;
+
+	predict(*t, dt>0 ? (ARFloat)dt : 0, pos, quat);
+	matrixFromQuat(quat, nTrans);
+	for(int i=0; i<3; i++)
+		nTrans[i][3] = pos[i];
+
+	return true;
+}
+
+
+bool
+PoseFilter::getSphere(int nId, double nTime, ARFloat nCenter[3], ARFloat* nRadius) const
+{
+	const Target* t = findTarget(nId);
+	ARFloat trans[3][4];
+
+	if(!t || !getPose(nId, nTime, trans))
+		return false;
+
+	for(int i=0; i<3; i++)
+		nCenter[i] = trans[i][0]*t->center[0] + trans[i][1]*t->center[1] + trans[i][2]*t->center[2] + trans[i][3];
+	*nRadius = t->radius;
+
+	return true;
+}
+
+
+double
+PoseFilter::getLastTime(int nId) const
+{
+	const Target* t = findTarget(nId);
+
+	return t ? t->time : -1.0;
+}
+
+
+}  // namespace ARToolKitPlus
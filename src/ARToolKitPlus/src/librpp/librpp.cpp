@@ -44,6 +44,7 @@
 #include "librpp.h"
 #include "rpp.h"
 #include "rpp_vecmat.h"
+#include "rpp_fixed.h"
 using namespace rpp;
 
 #ifdef LIBRPP_DLL
@@ -137,6 +138,109 @@ LIBRPP_API void robustPlanarPose(rpp_float &err,
 }
 
 
+template <unsigned int N>
+static void robustPlanarPoseN(rpp_float &err,
+							  rpp_mat &R,
+							  rpp_vec &t,
+							  const rpp_float cc[2],
+							  const rpp_float fc[2],
+							  const rpp_vec *model,
+							  const rpp_vec *iprts,
+							  const rpp_mat R_init,
+							  const bool estimate_R_init,
+							  const rpp_float epsilon,
+							  const rpp_float tolerance,
+							  const unsigned int max_iterations)
+{
+	vec3_t _model[N];
+	vec3_t _iprts[N];
+
+	mat33_t K, K_inv;
+	mat33_eye(K);
+	K.m[0][0] = (real_t)fc[0];
+	K.m[1][1] = (real_t)fc[1];
+	K.m[0][2] = (real_t)cc[0];
+	K.m[1][2] = (real_t)cc[1];
+
+	mat33_inv(K_inv, K);
+
+	for(unsigned int i=0; i<N; i++)
+	{
+		vec3_t _v;
+		vec3_assign(_model[i],(real_t)model[i][0],(real_t)model[i][1],(real_t)model[i][2]);
+		vec3_assign(_v,(real_t)iprts[i][0],(real_t)iprts[i][1],(real_t)iprts[i][2]);
+		vec3_mult(_iprts[i],K_inv,_v);
+	}
+
+	options_t options;
+	options.max_iter = max_iterations;
+	options.epsilon = (real_t)(epsilon == 0 ? DEFAULT_EPSILON : epsilon);
+	options.tol =     (real_t)(tolerance == 0 ? DEFAULT_TOL : tolerance);
+	if(estimate_R_init)
+		mat33_set_all_zeros(options.initR);
+	else
+	{
+		mat33_assign(options.initR,
+					(real_t)R_init[0][0], (real_t)R_init[0][1], (real_t)R_init[0][2],
+					(real_t)R_init[1][0], (real_t)R_init[1][1], (real_t)R_init[1][2],
+					(real_t)R_init[2][0], (real_t)R_init[2][1], (real_t)R_init[2][2]);
+	}
+
+	real_t _err;
+	mat33_t _R;
+	vec3_t _t;
+
+	robust_pose_fixed<N>(_err,_R,_t,_model,_iprts,options);
+
+	for(int j=0; j<3; j++)
+	{
+		R[j][0] = (rpp_float)_R.m[j][0];
+		R[j][1] = (rpp_float)_R.m[j][1];
+		R[j][2] = (rpp_float)_R.m[j][2];
+		t[j] = (rpp_float)_t.v[j];
+	}
+	err = (rpp_float)_err;
+}
+
+
+LIBRPP_API void robustPlanarPoseFixed(rpp_float &err,
+									  rpp_mat &R,
+									  rpp_vec &t,
+									  const rpp_float cc[2],
+									  const rpp_float fc[2],
+									  const rpp_vec *model,
+									  const rpp_vec *iprts,
+									  const unsigned int model_iprts_size,
+									  const rpp_mat R_init,
+									  const bool estimate_R_init,
+									  const rpp_float epsilon,
+									  const rpp_float tolerance,
+									  const unsigned int max_iterations)
+{
+	switch(model_iprts_size)
+	{
+	case 4:
+		robustPlanarPoseN<4>(err,R,t,cc,fc,model,iprts,R_init,estimate_R_init,epsilon,tolerance,max_iterations);
+		break;
+	case 5:
+		robustPlanarPoseN<5>(err,R,t,cc,fc,model,iprts,R_init,estimate_R_init,epsilon,tolerance,max_iterations);
+		break;
+	case 6:
+		robustPlanarPoseN<6>(err,R,t,cc,fc,model,iprts,R_init,estimate_R_init,epsilon,tolerance,max_iterations);
+		break;
+	case 7:
+		robustPlanarPoseN<7>(err,R,t,cc,fc,model,iprts,R_init,estimate_R_init,epsilon,tolerance,max_iterations);
+		break;
+	case 8:
+		robustPlanarPoseN<8>(err,R,t,cc,fc,model,iprts,R_init,estimate_R_init,epsilon,tolerance,max_iterations);
+		break;
+	default:
+		robustPlanarPose(err,R,t,cc,fc,model,iprts,model_iprts_size,R_init,estimate_R_init,epsilon,tolerance,max_iterations);
+		break;
+	}
+}
+
+
 bool rppSupportAvailabe()
 {
 	return true;
@@ -163,6 +267,23 @@ LIBRPP_API void robustPlanarPose(rpp_float &err,
 }
 
 
+LIBRPP_API void robustPlanarPoseFixed(rpp_float &err,
+									  rpp_mat &R,
+									  rpp_vec &t,
+									  const rpp_float cc[2],
+									  const rpp_float fc[2],
+									  const rpp_vec *model,
+									  const rpp_vec *iprts,
+									  const unsigned int model_iprts_size,
+									  const rpp_mat R_init,
+									  const bool estimate_R_init,
+									  const rpp_float epsilon,
+									  const rpp_float tolerance,
+									  const unsigned int max_iterations)
+{
+}
+
+
 bool rppSupportAvailabe()
 {
 	return false;
@@ -110,3 +110,25 @@ LIBRPP_API void robustPlanarPose(rpp_float &err,
     }
           
 */
+
+LIBRPP_API void robustPlanarPoseFixed(rpp_float &err,
+									  rpp_mat &R,
+									  rpp_vec &t,
+									  const rpp_float cc[2],
+									  const rpp_float fc[2],
+									  const rpp_vec *model,
+									  const rpp_vec *iprts,
+									  const unsigned int model_iprts_size,
+									  const rpp_mat R_init,
+									  const bool estimate_R_init,
+									  const rpp_float epsilon,
+									  const rpp_float tolerance,
+									  const unsigned int max_iterations);
+/*
+
+	Same parameters and results as robustPlanarPose(). For 4 to 8 point
+	correspondences a compile-time sized solver is used that keeps all
+	intermediate data on the stack (see rpp_fixed.h); other sizes are
+	forwarded to robustPlanarPose().
+
+*/
@@ -0,0 +1,747 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ *
+ * The robust pose estimator algorithm has been provided by G. Schweighofer
+ * and A. Pinz (Inst.of El.Measurement and Measurement Signal Processing,
+ * Graz University of Technology). Details about the algorithm are given in
+ * a Technical Report: TR-EMT-2005-01, available at:
+ * http://www.emt.tu-graz.ac.at/publications/index.htm
+ *
+ * Ported from MATLAB to C by T.Pintaric (Vienna University of Technology).
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+#ifndef __RPP_FIXED_H__
+#define __RPP_FIXED_H__
+
+#include "rpp_types.h"
+#include "rpp_const.h"
+#include "rpp_vecmat.h"
+#include "rpp.h"
+
+//
+// Compile-time sized variant of robust_pose() and its helpers.
+// All point sets are plain arrays of N elements and the (at most four)
+// candidate poses are kept in a fixed array, so a call performs no heap
+// allocation. The arithmetic is the same as in rpp.cpp, operation by
+// operation, hence both versions return identical poses.
+//
+
+namespace rpp {
+
+int svdcmp(double **a, int m, int n, double *w, double **v);
+int quartic(double[], double[], double[], int*);
+real_t _pow(real_t a, real_t b);
+
+// max. number of real roots of the quartic in getRotationY_wrtT()
+#define RPP_FIXED_MAX_SOL 4
+
+// ===========================================================================================
+inline void mat33_svd2_fixed(mat33_t &u, mat33_t &s, mat33_t &v, const mat33_t &m)
+{
+	double m_data[3][3], v_data[3][3], q_data[3] = {0,0,0};
+	double* m_ptr[3] = { m_data[0], m_data[1], m_data[2] };
+	double* v_ptr[3] = { v_data[0], v_data[1], v_data[2] };
+
+	for(unsigned int r=0; r<3; r++)
+		for(unsigned int c=0; c<3; c++)
+		{
+			m_data[r][c] = (double)m.m[r][c];
+			v_data[r][c] = 0.0;
+		}
+
+	/*int ret =*/ svdcmp(m_ptr, 3, 3, q_data, v_ptr);
+
+	for(unsigned int r=0; r<3; r++)
+		for(unsigned int c=0; c<3; c++)
+		{
+			u.m[r][c] = (real_t)m_data[r][c];
+			v.m[r][c] = (real_t)v_data[r][c];
+		}
+
+	mat33_clear(s);
+	s.m[0][0] = (real_t)q_data[0];
+	s.m[1][1] = (real_t)q_data[1];
+	s.m[2][2] = (real_t)q_data[2];
+}
+
+// ===========================================================================================
+inline int solve_polynomial_fixed(real_t r_sol[RPP_FIXED_MAX_SOL], const real_t coefficients[5])
+{
+	double dd[5] = {(double)coefficients[0],
+		(double)coefficients[1],
+		(double)coefficients[2],
+		(double)coefficients[3],
+		(double)coefficients[4] };
+
+	double sol[4] = {0,0,0,0};
+	double soli[4] = {0,0,0,0};
+	int n_sol = 0;
+	quartic(dd, sol, soli, &n_sol);
+
+	if(n_sol <= 0) return(0);
+
+	for(int i=0; i<n_sol; i++) r_sol[i] = (real_t)sol[i];
+	return(n_sol);
+}
+
+// ===========================================================================================
+template <unsigned int N>
+void vec3_array_sum_fixed(vec3_t &v_sum, const vec3_t (&va)[N])
+{
+	vec3_clear(v_sum);
+	for(unsigned int i=0; i<N; i++)
+	{
+		v_sum.v[0] += va[i].v[0];
+		v_sum.v[1] += va[i].v[1];
+		v_sum.v[2] += va[i].v[2];
+	}
+}
+
+template <unsigned int N>
+void vec3_array_sub_fixed(vec3_t (&va)[N], const vec3_t &a)
+{
+	for(unsigned int i=0; i<N; i++)
+	{
+		va[i].v[0] -= a.v[0];
+		va[i].v[1] -= a.v[1];
+		va[i].v[2] -= a.v[2];
+	}
+}
+
+template <unsigned int N>
+void mat33_array_sum_fixed(mat33_t &s, const mat33_t (&ma)[N])
+{
+	mat33_clear(s);
+	for(unsigned int i=0; i<N; i++)
+	{
+		for(unsigned int c=0; c<3; c++)
+		{
+			s.m[0][c] += ma[i].m[0][c];
+			s.m[1][c] += ma[i].m[1][c];
+			s.m[2][c] += ma[i].m[2][c];
+		}
+	}
+}
+
+// ===========================================================================================
+template <unsigned int N>
+void xform_fixed(vec3_t (&Q)[N], const vec3_t (&P)[N], const mat33_t &R, const vec3_t &t)
+{
+	for(unsigned int i=0; i<N; i++)
+	{
+		vec3_mult(Q[i],R,P[i]);
+		vec3_add(Q[i],t);
+	}
+}
+
+// ===========================================================================================
+template <unsigned int N>
+void xformproj_fixed(vec3_t (&Qp)[N], const vec3_t (&P)[N], const mat33_t &R, const vec3_t &t)
+{
+	for(unsigned int i=0; i<N; i++)
+	{
+		vec3_t Q;
+		vec3_mult(Q,R,P[i]);
+		vec3_add(Q,t);
+		Qp[i].v[0] = Q.v[0] / Q.v[2]; 
+		Qp[i].v[1] = Q.v[1] / Q.v[2]; 
+		Qp[i].v[2] = 1.0;
+	}
+}
+
+// ===========================================================================================
+template <unsigned int N>
+void abskernel_fixed(mat33_t &R, vec3_t &t, vec3_t (&Qout)[N], real_t &err2, 
+					 const vec3_t (&_P)[N], const vec3_t (&_Q)[N], 
+					 const mat33_t (&F)[N], const mat33_t &G)
+{
+	unsigned int i,j;
+
+	vec3_t P[N];
+	vec3_t Q[N];
+
+	for(i=0; i<N; i++)
+	{
+		vec3_copy(P[i],_P[i]);
+		vec3_mult(Q[i],F[i],_Q[i]);
+	}
+
+	vec3_t pbar;
+	vec3_array_sum_fixed(pbar,P);
+	vec3_div(pbar,real_t(N));
+	vec3_array_sub_fixed(P,pbar);
+
+	vec3_t qbar;
+	vec3_array_sum_fixed(qbar,Q);
+	vec3_div(qbar,real_t(N));
+	vec3_array_sub_fixed(Q,qbar);
+
+	mat33_t M;
+	mat33_clear(M);
+	for(j=0; j<N; j++)
+	{
+		mat33_t _m;
+		vec3_mul_vec3trans(_m,P[j],Q[j]);
+		mat33_add(M,_m);
+	}
+
+	mat33_t _U;
+	mat33_t _S;
+	mat33_t _V;
+	mat33_svd2_fixed(_U,_S,_V,M);
+
+	mat33_t _Ut;
+	mat33_transpose(_Ut,_U);
+	mat33_mult(R,_V,_Ut);
+
+	vec3_t _sum;
+	vec3_clear(_sum);
+	for(i=0; i<N; i++)
+	{
+		vec3_t _v1,_v2;
+		vec3_mult(_v1,R,P[i]);
+		vec3_mult(_v2,F[i],_v1);
+		vec3_add(_sum,_v2);
+	}
+
+	vec3_mult(t,G,_sum);
+	xform_fixed(Qout,P,R,t);
+	err2 = 0;
+	for(i=0; i<N; i++)
+	{
+		mat33_t _m1;
+		vec3_t _v1;
+		mat33_eye(_m1);
+		mat33_sub(_m1,F[i]);
+		vec3_mult(_v1,_m1,Qout[i]);
+		err2 += vec3_dot(_v1,_v1);
+	}
+}
+
+// ===========================================================================================
+template <unsigned int N>
+void objpose_fixed(mat33_t &R, vec3_t &t, unsigned int &it, real_t &obj_err, real_t &img_err,
+				   bool calc_img_err, const vec3_t (&_P)[N], const vec3_t (&Qp)[N],
+				   const options_t &options)
+{
+	unsigned int i,j;
+	vec3_t P[N];
+	vec3_t Q[N];
+	mat33_t F[N];
+
+	for(i=0; i<N; i++)
+		vec3_copy(P[i],_P[i]);
+
+	vec3_t pbar;
+	vec3_array_sum_fixed(pbar,P);
+	vec3_div(pbar,real_t(N));
+	vec3_array_sub_fixed(P,pbar);
+
+	for(i=0; i<N; i++)
+	{
+		vec3_copy(Q[i],Qp[i]);
+		Q[i].v[2] = 1;
+	}
+
+	vec3_t V;
+	for(i=0; i<N; i++)
+	{
+		V.v[0] = Q[i].v[0] / Q[i].v[2];
+		V.v[1] = Q[i].v[1] / Q[i].v[2];
+		V.v[2] = 1.0;
+		vec3_mul_vec3trans(F[i],V,V);
+		mat33_div(F[i],vec3trans_mul_vec3(V,V));
+	}
+
+	mat33_t tFactor;
+	{
+		mat33_t _m1,_m2,_m3;
+		mat33_eye(_m1);
+		mat33_array_sum_fixed(_m2,F);
+		mat33_div(_m2,real_t(N));
+		mat33_sub(_m3,_m1,_m2);
+		mat33_inv(tFactor,_m3);
+		mat33_div(tFactor,real_t(N));
+	}
+
+	it = 0;
+	bool initR_approximate = mat33_all_zeros(options.initR);
+	mat33_t Ri;
+	vec3_t ti;
+	vec3_t Qi[N];
+	real_t old_err, new_err;
+
+	// ----------------------------------------------------------------------------------------
+	if(!initR_approximate)
+	{
+		mat33_copy(Ri,options.initR);
+		vec3_t _sum;
+		vec3_clear(_sum);
+		for(j=0; j<N; j++)
+		{
+			vec3_t _v1, _v2;
+			mat33_t _m1,_m2;
+			mat33_eye(_m1);              
+			mat33_sub(_m2,F[j],_m1);
+			vec3_mult(_v1,Ri,P[j]);
+			vec3_mult(_v2,_m2,_v1);
+			vec3_add(_sum,_v2);
+		}
+		vec3_mult(ti,tFactor,_sum);
+		xform_fixed(Qi,P,Ri,ti);
+		old_err = 0;
+		vec3_t _v;
+		for(j=0; j<N; j++)
+		{
+			mat33_t _m1,_m2;
+			mat33_eye(_m1);
+			mat33_sub(_m2,F[j],_m1);
+			vec3_mult(_v,_m2,Qi[j]);
+			old_err += vec3_dot(_v,_v);
+		}
+	// ----------------------------------------------------------------------------------------
+	}
+	else
+	{
+		abskernel_fixed(Ri,ti,Qi,old_err,P,Q,F,tFactor);
+		it = 1;
+	}
+	// ----------------------------------------------------------------------------------------
+
+	abskernel_fixed(Ri,ti,Qi,new_err,P,Qi,F,tFactor);
+	it = it + 1;
+
+	while((_abs((old_err-new_err)/old_err) > options.tol) && (new_err > options.epsilon) &&
+		  (options.max_iter == 0 || it<options.max_iter))
+	{
+		old_err = new_err;
+		abskernel_fixed(Ri,ti,Qi,new_err,P,Qi,F,tFactor);
+		it = it + 1;
+	}
+
+
+	mat33_copy(R,Ri);
+	vec3_copy(t,ti);
+	obj_err = _sqrt(new_err/real_t(N));
+
+	if(calc_img_err)
+	{
+		vec3_t Qproj[N];
+		xformproj_fixed(Qproj, P, Ri, ti);
+		img_err = 0;
+
+		vec3_t _v;
+		for(j=0; j<N; j++)
+		{
+			vec3_sub(_v,Qproj[j],Qp[j]);
+			img_err += vec3_dot(_v,_v);
+		}
+		img_err = _sqrt(img_err/real_t(N));
+	}
+
+	if(t.v[2] < 0)
+	{
+		mat33_mult(R,-1.0);
+		vec3_mult(t,-1.0);
+	}
+
+	vec3_t _ts;
+	vec3_mult(_ts,Ri,pbar);
+	vec3_sub(t,_ts);
+}
+
+// =====================================================================================
+template <unsigned int N>
+int getRotationY_wrtT_fixed(real_t (&al_ret)[RPP_FIXED_MAX_SOL], vec3_t (&tnew)[RPP_FIXED_MAX_SOL],
+							const vec3_t (&v)[N], const vec3_t (&p)[N], const vec3_t &t,
+							const real_t &DB, const mat33_t &Rz)
+{
+	unsigned int i;
+	int j;
+	mat33_t V[N];
+	for(i=0; i<N; i++)
+	{
+		vec3_mul_vec3trans(V[i],v[i],v[i]);
+		mat33_div(V[i], vec3trans_mul_vec3(v[i],v[i]));
+	}
+
+	mat33_t G, _g1, _g2, _g3;
+	mat33_array_sum_fixed(_g1,V);
+	mat33_eye(_g2);
+	mat33_div(_g1,real_t(N));
+	mat33_sub(_g3,_g2,_g1);
+	mat33_inv(G, _g3);
+	mat33_div(G,real_t(N));
+	mat33_t _opt_t;
+	mat33_clear(_opt_t);
+
+	for(i=0; i<N; i++)
+	{
+		const real_t v11 = V[i].m[0][0]; 
+		const real_t v21 = V[i].m[1][0];
+		const real_t v31 = V[i].m[2][0];
+		const real_t v12 = V[i].m[0][1]; 
+		const real_t v22 = V[i].m[1][1];
+		const real_t v32 = V[i].m[2][1];
+		const real_t v13 = V[i].m[0][2]; 
+		const real_t v23 = V[i].m[1][2];
+		const real_t v33 = V[i].m[2][2];
+		const real_t px = p[i].v[0];
+		const real_t py = p[i].v[1];
+		const real_t pz = p[i].v[2];
+		const real_t r1 = Rz.m[0][0];
+		const real_t r2 = Rz.m[0][1];
+		const real_t r3 = Rz.m[0][2];
+		const real_t r4 = Rz.m[1][0];
+		const real_t r5 = Rz.m[1][1];
+		const real_t r6 = Rz.m[1][2];
+		const real_t r7 = Rz.m[2][0];
+		const real_t r8 = Rz.m[2][1];
+		const real_t r9 = Rz.m[2][2];
+
+		mat33_t _o;
+		_o.m[0][0] = (((v11-real_t(1))*r2+v12*r5+v13*r8)*py+(-(v11-real_t(1))*r1-v12*r4-v13*r7)*px+(-(v11-real_t(1))*r3-v12*r6-v13*r9)*pz);
+		_o.m[0][1] = ((real_t(2)*(v11-real_t(1))*r1+real_t(2)*v12*r4+real_t(2)*v13*r7)*pz+(-real_t(2)*(v11-real_t(1))*r3-real_t(2)*v12*r6-real_t(2)*v13*r9)*px);
+		_o.m[0][2] = ((v11-real_t(1))*r1+v12*r4+v13*r7)*px+((v11-real_t(1))*r3+v12*r6+v13*r9)*pz+((v11-real_t(1))*r2+v12*r5+v13*r8)*py;
+
+		_o.m[1][0] = ((v21*r2+(v22-real_t(1))*r5+v23*r8)*py+(-v21*r1-(v22-real_t(1))*r4-v23*r7)*px+(-v21*r3-(v22-real_t(1))*r6-v23*r9)*pz);
+		_o.m[1][1] = ((real_t(2)*v21*r1+real_t(2)*(v22-real_t(1))*r4+real_t(2)*v23*r7)*pz+(-real_t(2)*v21*r3-real_t(2)*(v22-real_t(1))*r6-real_t(2)*v23*r9)*px);
+		_o.m[1][2] = (v21*r1+(v22-real_t(1))*r4+v23*r7)*px+(v21*r3+(v22-real_t(1))*r6+v23*r9)*pz+(v21*r2+(v22-real_t(1))*r5+v23*r8)*py;
+
+		_o.m[2][0] = ((v31*r2+v32*r5+(v33-real_t(1))*r8)*py+(-v31*r1-v32*r4-(v33-real_t(1))*r7)*px+(-v31*r3-v32*r6-(v33-real_t(1))*r9)*pz);
+		_o.m[2][1] = ((real_t(2)*v31*r1+real_t(2)*v32*r4+real_t(2)*(v33-real_t(1))*r7)*pz+(-real_t(2)*v31*r3-real_t(2)*v32*r6-real_t(2)*(v33-real_t(1))*r9)*px);
+		_o.m[2][2] = (v31*r1+v32*r4+(v33-real_t(1))*r7)*px+(v31*r3+v32*r6+(v33-real_t(1))*r9)*pz+(v31*r2+v32*r5+(v33-real_t(1))*r8)*py;
+
+		mat33_add(_opt_t,_o);
+	}
+
+	mat33_t opt_t;
+	mat33_mult(opt_t,G,_opt_t);
+	real_t E_2[5] = {0,0,0,0,0};
+	for(i=0; i<N; i++)
+	{
+		const real_t px = p[i].v[0];
+		const real_t py = p[i].v[1];
+		const real_t pz = p[i].v[2];
+
+		mat33_t Rpi;
+		mat33_assign(Rpi,-px,real_t(2)*pz,px,py,real_t(0),py,-pz,-real_t(2)*px,pz);
+
+		mat33_t E,_e1,_e2;
+		mat33_eye(_e1);
+		mat33_sub(_e1,V[i]);
+		mat33_mult(_e2,Rz,Rpi);
+		mat33_add(_e2,opt_t);
+		mat33_mult(E,_e1,_e2);
+		vec3_t e2,e1,e0;
+		mat33_to_col_vec3(e2,e1,e0,E);
+		vec3_t _E2_0,_E2_1,_E2_2,_E2_3,_E2_4;
+		vec3_copy(_E2_0,e2);
+		vec3_mult(_E2_0,e2);
+		vec3_copy(_E2_1,e1);
+		vec3_mult(_E2_1,e2);
+		vec3_mult(_E2_1,2.0f);
+		vec3_copy(_E2_2,e0);
+		vec3_mult(_E2_2,e2);
+		vec3_mult(_E2_2,2.0f);
+		vec3_t _e1_sq;
+		vec3_copy(_e1_sq,e1);
+		vec3_mult(_e1_sq,e1);
+		vec3_add(_E2_2,_e1_sq);
+		vec3_copy(_E2_3,e0);
+		vec3_mult(_E2_3,e1);
+		vec3_mult(_E2_3,2.0f);
+		vec3_copy(_E2_4,e0);
+		vec3_mult(_E2_4,e0);
+		E_2[0] += vec3_sum(_E2_0);
+		E_2[1] += vec3_sum(_E2_1);
+		E_2[2] += vec3_sum(_E2_2);
+		E_2[3] += vec3_sum(_E2_3);
+		E_2[4] += vec3_sum(_E2_4);
+	}
+
+	real_t _a[5];
+	_a[4] = -E_2[1];
+	_a[3] = real_t(4)*E_2[0] - real_t(2)*E_2[2];
+	_a[2] = -real_t(3)*E_2[3] + real_t(3)*E_2[1];
+	_a[1] = -real_t(4)*E_2[4] + real_t(2)*E_2[2];
+	_a[0] = E_2[3];
+
+	real_t at_sol[RPP_FIXED_MAX_SOL];
+	const int num_sol = solve_polynomial_fixed(at_sol, _a);
+
+	// keep the real roots of the polynomial (e == 0)
+	// and drop those where (1+at^2)^3 vanishes
+	real_t at[RPP_FIXED_MAX_SOL];
+	int num_at = 0;
+	for(i=0; i<(unsigned int)num_sol; i++)
+	{
+		real_t e = 0;
+		e += _a[0];
+		e += at_sol[i]*_a[1];
+		for(j=2; j<=4; j++)
+			e += _pow(at_sol[i],real_t(j))*_a[j];
+
+		if(_abs(e) < real_t(1e-3))
+		{
+			real_t p1 = _pow(at_sol[i],2);
+			p1 += 1;
+			p1 = _pow(p1,3);
+			if(_abs(p1) > real_t(0.1f)) at[num_at++] = at_sol[i];
+		}
+	}
+
+	// convert tangents to angles; only minima of the error function are kept
+	int num_al = 0;
+	for(j=0; j<num_at; j++)
+	{
+		real_t sa = at[j];
+		sa *= 2;
+		real_t _ca1 = _pow(at[j],2);
+		_ca1 += 1;
+		real_t ca = _pow(at[j],2);
+		ca = -ca;
+		ca += 1;
+		ca /= _ca1;
+		sa /= _ca1;
+		real_t al = _atan2(sa,ca);
+		al *= real_t(180./CONST_PI);
+
+		real_t tMaxMin = 0;
+		tMaxMin += _a[1];
+		real_t _at = at[j];
+		_at *= _a[2];
+		_at *= 2;
+		tMaxMin += _at;
+		for(int k=3; k<=4; k++)
+		{
+			_at = _pow(at[j],(real_t)real_t(k)-real_t(1.0f));
+			_at *= _a[k];
+			_at *= real_t(k);
+			tMaxMin += _at;
+		}
+
+		if(tMaxMin > 0) al_ret[num_al++] = al;
+	}
+
+	for(j=0; j<num_al; j++)
+	{
+		vec3_t rpy;
+		vec3_assign(rpy,real_t(0),real_t(al_ret[j] * CONST_PI / real_t(180)), real_t(0));
+		mat33_t R,Ry_;
+		rpyMat(Ry_,rpy);
+		mat33_mult(R,Rz,Ry_);
+		vec3_t t_opt;
+		vec3_clear(t_opt);
+
+		for(i=0; i<N; i++)
+		{
+			mat33_t _m1,_eye3;
+			mat33_eye(_eye3);
+			mat33_copy(_m1,V[i]);
+			mat33_sub(_m1,_eye3);
+			vec3_t _v1,_v2;
+			vec3_mult(_v1,R,p[i]);
+			vec3_mult(_v2,_m1,_v1);
+			vec3_add(t_opt,_v2);
+		}
+
+		vec3_mult(tnew[j],G,t_opt);
+	}
+
+	return(num_al);
+}
+
+// =====================================================================================
+template <unsigned int N>
+int getRfor2ndPose_V_Exact_fixed(pose_t (&sol)[RPP_FIXED_MAX_SOL], const vec3_t (&v)[N],
+								 const vec3_t (&P)[N], const mat33_t &R, const vec3_t &t,
+								 const real_t DB)
+{
+	mat33_t RzN;
+	decomposeR(RzN, R);
+	mat33_t R_;
+	mat33_mult(R_,R,RzN);
+	mat33_t RzN_tr;
+	mat33_transpose(RzN_tr,RzN);
+	vec3_t P_[N];
+	for(unsigned int i=0; i<N; i++)
+		vec3_mult(P_[i],RzN_tr,P[i]);
+	vec3_t ang_zyx;
+	rpyAng_X(ang_zyx,R_);
+	vec3_t rpy;
+	mat33_t Ry,Rz;
+	vec3_assign(rpy,0,ang_zyx.v[1],0);
+	rpyMat(Ry,rpy);
+	vec3_assign(rpy,0,0,ang_zyx.v[2]);
+	rpyMat(Rz,rpy);
+	real_t bl[RPP_FIXED_MAX_SOL];
+	vec3_t Tnew[RPP_FIXED_MAX_SOL];
+	const int num_sol = getRotationY_wrtT_fixed(bl,Tnew, v ,P_, t, DB, Rz);
+	const real_t bl_scale = 180.0f/CONST_PI;
+	mat33_t V[N];
+	for(unsigned int i=0; i<N; i++)
+	{
+		vec3_mul_vec3trans(V[i],v[i],v[i]);
+		mat33_div(V[i],vec3trans_mul_vec3(v[i],v[i]));
+	}
+
+	for(int j=0; j<num_sol; j++)
+	{
+		bl[j] /= bl_scale;
+		mat33_clear(Ry);
+		vec3_assign(rpy,0,bl[j],0);
+		rpyMat(Ry,rpy);
+		mat33_t _m1;
+		mat33_mult(_m1,Rz,Ry);
+		mat33_mult(sol[j].R,_m1,RzN_tr);
+		vec3_copy(sol[j].t,Tnew[j]);
+		real_t E = 0;
+		for(unsigned int i=0; i<N; i++)
+		{
+			mat33_t _m2;
+			mat33_eye(_m2);
+			mat33_sub(_m2,V[i]);
+			vec3_t _v1;
+			vec3_mult(_v1,sol[j].R,P[i]);
+			vec3_add(_v1,sol[j].t);
+			vec3_t _v2;
+			vec3_mult(_v2,_m2,_v1);
+			vec3_mult(_v2,_v2);
+			E += vec3_sum(_v2);
+		}
+		sol[j].E = E;
+	}
+
+	return(num_sol);
+}
+
+// =====================================================================================
+template <unsigned int N>
+int get2ndPose_Exact_fixed(pose_t (&sol)[RPP_FIXED_MAX_SOL], const vec3_t (&v)[N],
+						   const vec3_t (&P)[N], const mat33_t &R, const vec3_t &t,
+						   const real_t DB)
+{
+	vec3_t cent, _v1;
+	vec3_t _va1[N];
+	for(unsigned int i=0; i<N; i++)
+		normRv(_va1[i],v[i]);
+	vec3_array_sum_fixed(_v1,_va1);
+	vec3_div(_v1,real_t(N));
+	normRv(cent,_v1);
+	mat33_t Rim;
+	vec3_clear(_v1);
+	_v1.v[2] = 1.0f;
+	GetRotationbyVector(Rim,_v1,cent);
+	vec3_t v_[N];
+	for(unsigned int i=0; i<N; i++)
+		vec3_mult(v_[i],Rim,v[i]);
+	mat33_t R_;
+	vec3_t  t_;
+	mat33_mult(R_,Rim,R);
+	vec3_mult(t_,Rim,t);
+	const int num_sol = getRfor2ndPose_V_Exact_fixed(sol,v_,P,R_,t_,DB);
+	mat33_t Rim_tr;
+	mat33_transpose(Rim_tr,Rim);
+	for(int i=0; i<num_sol; i++)
+	{
+		vec3_t _t;
+		mat33_t _R;
+		vec3_mult(_t,Rim_tr,sol[i].t);
+		mat33_mult(_R,Rim_tr,sol[i].R);
+
+		vec3_copy(sol[i].t,_t);
+		mat33_copy(sol[i].R,_R);
+	}
+
+	return(num_sol);
+}
+
+// =====================================================================================
+template <unsigned int N>
+void robust_pose_fixed(real_t &err, mat33_t &R, vec3_t &t,
+					   const vec3_t (&model)[N], const vec3_t (&iprts)[N],
+					   const options_t &_options)
+{
+	mat33_t Rlu_;
+	vec3_t tlu_;
+	unsigned int it1_;
+	real_t obj_err1_;
+	real_t img_err1_;
+
+	options_t options = _options;
+
+	mat33_clear(Rlu_);
+	vec3_clear(tlu_);
+	it1_ = 0;
+	obj_err1_ = 0;
+	img_err1_ = 0;
+
+	objpose_fixed(Rlu_, tlu_, it1_, obj_err1_, img_err1_, true, model, iprts, options);
+
+	pose_t sol[RPP_FIXED_MAX_SOL];
+	const int num_sol = get2ndPose_Exact_fixed(sol,iprts,model,Rlu_,tlu_,0);
+	int min_err_idx = (-1);
+	real_t min_err = MAX_FLOAT;
+	for(int i=0; i<num_sol; i++)
+	{
+		mat33_copy(options.initR,sol[i].R);
+		objpose_fixed(Rlu_, tlu_, it1_, obj_err1_, img_err1_, true, model, iprts, options);
+		mat33_copy(sol[i].PoseLu_R,Rlu_);
+		vec3_copy(sol[i].PoseLu_t,tlu_);
+		sol[i].obj_err = obj_err1_;
+		if(sol[i].obj_err < min_err)
+		{
+			min_err = sol[i].obj_err;
+			min_err_idx = i;
+		}
+	}
+
+	if(min_err_idx >= 0)
+	{
+		mat33_copy(R,sol[min_err_idx].PoseLu_R);
+		vec3_copy(t,sol[min_err_idx].PoseLu_t);
+		err = sol[min_err_idx].obj_err;
+	}
+	else
+	{
+		mat33_clear(R);
+		vec3_clear(t);
+		err = MAX_FLOAT;
+	}
+}
+
+// ----------------------------------------
+} // namespace rpp
+
+#endif //__RPP_FIXED_H__
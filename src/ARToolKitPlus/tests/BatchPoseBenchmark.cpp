@@ -0,0 +1,165 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+// Times executeSingleMarkerPoseEstimatorBatch() for 16 markers in a 640x480
+// image with different numbers of OpenMP threads and checks that the poses
+// do not depend on the number of threads. Without OpenMP only the serial
+// time is printed.
+//
+// Usage: BatchPoseBenchmark [camera file]
+// Returns 0 if all thread counts give the same poses.
+
+
+#include <ARToolKitPlus/TrackerSingleMarkerImpl.h>
+#include "SyntheticMarkers.h"
+#include <stdio.h>
+#include <time.h>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+
+using namespace ARToolKitPlus;
+
+
+#define NUM_MARKERS		16
+#define NUM_RUNS		200
+
+
+typedef TrackerSingleMarkerImpl<6,6,6,1,NUM_MARKERS> BatchTracker;
+
+
+// wall clock time, clock() would sum up the time of all threads
+static double
+getSeconds()
+{
+#if defined(_OPENMP)
+	return omp_get_wtime();
+#else
+	return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+
+static bool
+runEstimator(BatchTracker& nTracker, POSE_ESTIMATOR nEstimator, const char* nName,
+			 ARMarkerInfo* nMarkers, int nNumMarkers)
+{
+	static ARFloat conv[NUM_MARKERS][3][4], refConv[NUM_MARKERS][3][4];
+	ARFloat center[2] = { 0.0f, 0.0f }, err[NUM_MARKERS], refErr[NUM_MARKERS];
+	bool same = true;
+	int maxThreads = 1;
+
+#if defined(_OPENMP)
+	maxThreads = omp_get_max_threads();
+	omp_set_num_threads(1);
+#endif
+
+	nTracker.setPoseEstimator(nEstimator);
+	nTracker.executeSingleMarkerPoseEstimatorBatch(nMarkers, nNumMarkers, center, 80.0f, refConv, refErr);
+
+	for(int threads=1; threads<=maxThreads; threads*=2)
+	{
+#if defined(_OPENMP)
+		omp_set_num_threads(threads);
+#endif
+		double start = getSeconds();
+
+		for(int r=0; r<NUM_RUNS; r++)
+			nTracker.executeSingleMarkerPoseEstimatorBatch(nMarkers, nNumMarkers, center, 80.0f, conv, err);
+
+		double usec = 1.0e6 * (getSeconds()-start) / NUM_RUNS;
+
+		for(int i=0; i<nNumMarkers; i++)
+			if(err[i]!=refErr[i] || memcmp(conv[i], refConv[i], sizeof(conv[i]))!=0)
+				same = false;
+
+		printf("%-9s %2d thread(s): %8.1f us per batch of %d markers\n", nName, threads, usec, nNumMarkers);
+	}
+
+#if defined(_OPENMP)
+	omp_set_num_threads(maxThreads);
+#endif
+
+	return same;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	const char* cameraFile = argc>1 ? argv[1] : TEST_CAMERA_FILE;
+	static unsigned char pixels[640*480];
+	BatchTracker tracker(640, 480);
+	ARMarkerInfo* markers;
+	int i, numMarkers = 0;
+	bool ok = true;
+
+	tracker.setPixelFormat(PIXEL_FORMAT_LUM);
+	if(!tracker.init(cameraFile, 1.0f, 1000.0f))
+	{
+		printf("could not load camera file '%s'\n", cameraFile);
+		return 1;
+	}
+	tracker.setBorderWidth(0.25f);
+	tracker.setMarkerMode(MARKER_ID_BCH);
+
+	clearTestImage(pixels, 640, 480);
+	for(i=0; i<NUM_MARKERS; i++)
+		drawTestMarker(pixels, 640, 480, 10+i, 80+(i%4)*160, 70+(i/4)*113, 80, 0.1*i);
+
+	tracker.arDetectMarker(pixels, 128, &markers, &numMarkers);
+	if(numMarkers!=NUM_MARKERS)
+	{
+		printf("found %d of %d markers\n", numMarkers, NUM_MARKERS);
+		return 1;
+	}
+
+#if !defined(_OPENMP)
+	printf("built without OpenMP\n");
+#endif
+
+	ok = runEstimator(tracker, POSE_ESTIMATOR_ORIGINAL, "ORIGINAL", markers, numMarkers) && ok;
+	ok = runEstimator(tracker, POSE_ESTIMATOR_RPP, "RPP", markers, numMarkers) && ok;
+	ok = runEstimator(tracker, POSE_ESTIMATOR_LM, "LM", markers, numMarkers) && ok;
+
+	printf(ok ? "OK\n" : "FAILED\n");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+// Compares the id pattern downsampling of the tracker with the previous
+// hand written implementation on random pattern images. The previous code
+// only handled 6x6, 12x12 and 18x18 patterns. Larger multiples of the 6x6 id
+// grid are compared with the same per cell averaging written as a plain loop.
+//
+// Returns 0 if all results are identical.
+
+
+#include <ARToolKitPlus/TrackerSingleMarkerImpl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+using namespace ARToolKitPlus;
+
+
+#define NUM_PATTERNS	10000
+
+
+// the downsampling as it was implemented before it became a template
+template <int PATTERN_WIDTH, int PATTERN_HEIGHT>
+static int
+previousDownsample(const ARUint8* data, unsigned char* imgPtr)
+{
+	int x,y;
+
+	if(PATTERN_WIDTH==18 && PATTERN_HEIGHT==18)
+	{
+		for(y=0; y<PATTERN_HEIGHT; y+=3)
+			for(x=0; x<PATTERN_WIDTH; x+=3)
+			{
+				int idx = (y*PATTERN_WIDTH+x)*3, val=0;
+				val = (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+
+				idx += 3;
+				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+
+				idx += 3;
+				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+
+				idx += PATTERN_WIDTH*3 - 6;
+				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+
+				idx += 3;
+				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+
+				idx += 3;
+				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+
+				idx += PATTERN_WIDTH*3 - 6;
+				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+
+				idx += 3;
+				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+
+				idx += 3;
+				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+
+				*imgPtr++ = val/9;
+			}
+	}
+	else
+	if(PATTERN_WIDTH==12 && PATTERN_HEIGHT==12)
+	{
+		for(y=0; y<PATTERN_HEIGHT; y+=2)
+			for(x=0; x<PATTERN_WIDTH; x+=2)
+			{
+				int idx = (y*PATTERN_WIDTH+x)*3, val=0;
+				val = (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+
+				idx += 3;
+				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+
+				idx += PATTERN_WIDTH*3 - 3;
+				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+
+				idx += 3;
+				val += (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+
+				*imgPtr++ = val/4;
+			}
+	}
+	else
+	if(PATTERN_WIDTH==6 && PATTERN_HEIGHT==6)
+	{
+		for(int idx=0; idx<PATTERN_WIDTH*PATTERN_HEIGHT*3; idx+=3)
+			*imgPtr++ = (data[idx+0]+(data[idx+1]<<1)+data[idx+2])>>2;
+	}
+	else
+		return -1;
+
+	return 0;
+}
+
+
+// the same averaging for any multiple of the 6x6 grid
+template <int PATTERN_WIDTH, int PATTERN_HEIGHT>
+static void
+loopDownsample(const ARUint8* data, unsigned char* imgPtr)
+{
+	const int cellX = PATTERN_WIDTH/6, cellY = PATTERN_HEIGHT/6;
+
+	for(int gy=0; gy<6; gy++)
+		for(int gx=0; gx<6; gx++)
+		{
+			int val = 0;
+
+			for(int y=gy*cellY; y<(gy+1)*cellY; y++)
+				for(int x=gx*cellX; x<(gx+1)*cellX; x++)
+				{
+					const ARUint8* pix = data + (y*PATTERN_WIDTH+x)*3;
+					val += (pix[0]+(pix[1]<<1)+pix[2])>>2;
+				}
+
+			*imgPtr++ = (unsigned char)(val/(cellX*cellY));
+		}
+}
+
+
+template <int PATTERN_WIDTH, int PATTERN_HEIGHT>
+class DownsampleTracker : public TrackerSingleMarkerImpl<PATTERN_WIDTH, PATTERN_HEIGHT, PATTERN_WIDTH, 1, 8>
+{
+public:
+	int downsample(ARUint8* nData, unsigned char* nGrid)  {  return this->downsamplePattern(nData, nGrid);  }
+};
+
+
+template <int PATTERN_WIDTH, int PATTERN_HEIGHT>
+static bool
+testDownsample()
+{
+	static DownsampleTracker<PATTERN_WIDTH, PATTERN_HEIGHT> tracker;
+	ARUint8 data[PATTERN_WIDTH*PATTERN_HEIGHT*3];
+	unsigned char grid[36], prevGrid[36], loopGrid[36];
+	int i, j, numDiff = 0;
+	bool hasPrevious = true;
+
+	for(i=0; i<NUM_PATTERNS; i++)
+	{
+		// alternate between noise and saturated values to cover the full range
+		for(j=0; j<PATTERN_WIDTH*PATTERN_HEIGHT*3; j++)
+			data[j] = (ARUint8)((i&1) ? ((rand()&1) ? 255 : 0) : rand()&0xff);
+
+		if(tracker.downsample(data, grid)!=0)
+		{
+			printf("%dx%d: pattern rejected\n", PATTERN_WIDTH, PATTERN_HEIGHT);
+			return false;
+		}
+
+		loopDownsample<PATTERN_WIDTH, PATTERN_HEIGHT>(data, loopGrid);
+		hasPrevious = previousDownsample<PATTERN_WIDTH, PATTERN_HEIGHT>(data, prevGrid)==0;
+
+		// the loop version has to agree with the previous code, too
+		if(memcmp(grid, loopGrid, sizeof(grid))!=0 || (hasPrevious && memcmp(grid, prevGrid, sizeof(grid))!=0))
+			numDiff++;
+	}
+
+	printf("%2dx%-2d (%s): %d of %d patterns differ\n", PATTERN_WIDTH, PATTERN_HEIGHT,
+		   hasPrevious ? "previous code" : "plain loop", numDiff, NUM_PATTERNS);
+
+	return numDiff==0;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	bool ok = true;
+
+	srand(1);
+
+	ok = testDownsample<6,6>() && ok;
+	ok = testDownsample<12,12>() && ok;
+	ok = testDownsample<18,18>() && ok;
+	ok = testDownsample<24,24>() && ok;
+	ok = testDownsample<30,30>() && ok;
+
+	printf(ok ? "OK\n" : "FAILED\n");
+	return ok ? 0 : 1;
+}
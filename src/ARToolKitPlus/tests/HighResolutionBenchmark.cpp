@@ -0,0 +1,137 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+// Detects three BCH markers (far, middle and one spanning 0.8 of the image
+// height) plus a field of small blobs in 2560x1440 and 3840x2160 LUM images
+// and prints the detection time. Images this large need the wider types of
+// AR_HIGH_RESOLUTION, so it is defined here before any header is included.
+//
+// Usage: HighResolutionBenchmark [camera file]
+// Returns 0 if all markers are found at both resolutions.
+
+
+#define AR_HIGH_RESOLUTION
+
+#include <ARToolKitPlus/TrackerSingleMarkerImpl.h>
+#include "SyntheticMarkers.h"
+#include <stdio.h>
+#include <time.h>
+
+
+using namespace ARToolKitPlus;
+
+
+#define NUM_MARKERS		3
+#define NUM_RUNS		5
+
+
+typedef TrackerSingleMarkerImpl<6,6,6,1,8> HighResTracker;
+
+
+static bool
+runResolution(const char* nCameraFile, int nWidth, int nHeight)
+{
+	static const int ids[NUM_MARKERS] = { 5, 9, 12 };
+	unsigned char* pixels = new unsigned char[nWidth*nHeight];
+	HighResTracker* tracker = new HighResTracker(nWidth, nHeight);
+	ARMarkerInfo* markers;
+	int i, j, x, y, numMarkers = 0, numFound = 0;
+	double best = 0;
+
+	tracker->setPixelFormat(PIXEL_FORMAT_LUM);
+	if(!tracker->init(nCameraFile, 1.0f, 1000.0f))
+	{
+		printf("could not load camera file '%s'\n", nCameraFile);
+		delete tracker;
+		delete [] pixels;
+		return false;
+	}
+	tracker->setBorderWidth(0.25f);
+	tracker->setMarkerMode(MARKER_ID_BCH);
+	tracker->setUndistortionMode(UNDIST_LUT);
+
+	clearTestImage(pixels, nWidth, nHeight);
+	drawTestMarker(pixels, nWidth, nHeight, ids[0], nWidth*0.12, nHeight*0.15, nHeight*0.06, 0.2);
+	drawTestMarker(pixels, nWidth, nHeight, ids[1], nWidth*0.3, nHeight*0.7, nHeight*0.25, -0.3);
+	drawTestMarker(pixels, nWidth, nHeight, ids[2], nWidth*0.68, nHeight*0.5, nHeight*0.8, 0.1);
+
+	// lots of tiny labels, these overflow the 16 bit label image of the default build
+	for(y=4; y<nHeight/10; y+=6)
+		for(x=nWidth/2; x<nWidth-4; x+=6)
+			pixels[y*nWidth+x] = pixels[y*nWidth+x+1] = 0;
+
+	for(i=0; i<NUM_RUNS; i++)
+	{
+		clock_t start = clock();
+		tracker->arDetectMarker(pixels, 128, &markers, &numMarkers);
+		double ms = 1000.0 * (clock()-start) / CLOCKS_PER_SEC;
+
+		if(i==0 || ms<best)
+			best = ms;
+	}
+
+	for(i=0; i<NUM_MARKERS; i++)
+		for(j=0; j<numMarkers; j++)
+			if(markers[j].id==ids[i])
+			{
+				numFound++;
+				break;
+			}
+
+	printf("%dx%d: %d of %d markers found, %.1f ms per frame\n", nWidth, nHeight, numFound, NUM_MARKERS, best);
+
+	tracker->cleanup();
+	delete tracker;
+	delete [] pixels;
+	return numFound==NUM_MARKERS;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	const char* cameraFile = argc>1 ? argv[1] : TEST_CAMERA_FILE;
+	bool ok = true;
+
+	ok = runResolution(cameraFile, 2560, 1440) && ok;
+	ok = runResolution(cameraFile, 3840, 2160) && ok;
+
+	printf(ok ? "OK\n" : "FAILED\n");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,233 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+// Tracks four multi-marker boards (four markers each) in a 640x480 image
+// with one TrackerMultiMarkerImpl and times calc() with different numbers of
+// OpenMP threads. The poses of all configs have to be the same with one and
+// with all threads. Without OpenMP only the serial time is printed.
+//
+// Usage: MultiConfigBenchmark [camera file]
+// Returns 0 if all boards are tracked and all thread counts agree.
+
+
+#include <ARToolKitPlus/TrackerMultiMarkerImpl.h>
+#include "SyntheticMarkers.h"
+#include <stdio.h>
+#include <time.h>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+
+using namespace ARToolKitPlus;
+
+
+#define NUM_BOARDS		4
+#define NUM_RUNS		100
+#define CONFIG_FILE		"multiconfig.dat"
+
+
+typedef TrackerMultiMarkerImpl<6,6,6,1,16> MultiTracker;
+
+
+static double
+getSeconds()
+{
+#if defined(_OPENMP)
+	return omp_get_wtime();
+#else
+	return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+
+// a 2x2 board of 80 mm markers with 100 mm spacing using the ids nFirstId..nFirstId+3
+static bool
+writeBoardConfig(const char* nFileName, int nFirstId)
+{
+	FILE* fp = fopen(nFileName, "w");
+
+	if(!fp)
+		return false;
+
+	fprintf(fp, "4\n");
+	for(int m=0; m<4; m++)
+		fprintf(fp, "%d\n80.0\n0.0 0.0\n1 0 0 %d\n0 1 0 %d\n0 0 1 0\n", nFirstId+m, (m&1)*100, -(m>>1)*100);
+
+	fclose(fp);
+	return true;
+}
+
+
+static void
+setNumThreads(int nThreads)
+{
+#if defined(_OPENMP)
+	omp_set_num_threads(nThreads);
+#endif
+}
+
+
+// nTimed is timed with 1, 2, 4, ... threads. nSerial (1 thread) and nParallel
+// (all threads) get the same frames, so their poses have to match exactly.
+// comparing against earlier frames does not work, since the multi-marker
+// pose estimators start from the previous pose.
+//
+static bool
+runEstimator(MultiTracker* nTimed, MultiTracker* nSerial, MultiTracker* nParallel,
+			 POSE_ESTIMATOR nEstimator, const char* nName, const unsigned char* nImage)
+{
+	ARFloat mat[3][4], refMat[3][4];
+	bool ok = true;
+	int b, r, maxThreads = 1;
+
+#if defined(_OPENMP)
+	maxThreads = omp_get_max_threads();
+#endif
+
+	nTimed->setPoseEstimator(nEstimator);
+	nSerial->setPoseEstimator(nEstimator);
+	nParallel->setPoseEstimator(nEstimator);
+
+	for(r=0; r<NUM_RUNS; r++)
+	{
+		setNumThreads(1);
+		nSerial->calc(nImage);
+		setNumThreads(maxThreads);
+		nParallel->calc(nImage);
+
+		for(b=0; b<NUM_BOARDS; b++)
+		{
+			nSerial->getARMatrix(b, refMat);
+			nParallel->getARMatrix(b, mat);
+			if(!nSerial->isMultiMarkerConfigTracked(b) || memcmp(mat, refMat, sizeof(mat))!=0)
+				ok = false;
+		}
+	}
+
+	if(!ok)
+		printf("%s: boards not tracked or poses depend on the number of threads\n", nName);
+
+	for(int threads=1; threads<=maxThreads; threads*=2)
+	{
+		setNumThreads(threads);
+		double start = getSeconds();
+
+		for(r=0; r<NUM_RUNS; r++)
+			nTimed->calc(nImage);
+
+		printf("%-9s %2d thread(s): %8.1f us per frame with %d configs\n", nName, threads,
+			   1.0e6 * (getSeconds()-start) / NUM_RUNS, NUM_BOARDS);
+	}
+
+	setNumThreads(maxThreads);
+	return ok;
+}
+
+
+// loads the camera and one config per board
+static bool
+initTracker(MultiTracker* nTracker, const char* nCameraFile)
+{
+	nTracker->setPixelFormat(PIXEL_FORMAT_LUM);
+
+	for(int b=0; b<NUM_BOARDS; b++)
+	{
+		if(!writeBoardConfig(CONFIG_FILE, 1+b*4))
+			return false;
+
+		if(b==0 ? !nTracker->init(nCameraFile, CONFIG_FILE, 1.0f, 1000.0f) : nTracker->addMultiMarkerConfig(CONFIG_FILE)!=b)
+		{
+			printf("could not load camera file '%s' or board config %d\n", nCameraFile, b);
+			remove(CONFIG_FILE);
+			return false;
+		}
+	}
+	remove(CONFIG_FILE);
+
+	nTracker->setBorderWidth(0.25f);
+	nTracker->setMarkerMode(MARKER_ID_BCH);
+	return true;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	const char* cameraFile = argc>1 ? argv[1] : TEST_CAMERA_FILE;
+	static unsigned char pixels[640*480];
+	MultiTracker *timed = new MultiTracker(640, 480),
+				 *serial = new MultiTracker(640, 480),
+				 *parallel = new MultiTracker(640, 480);
+	int b, m;
+	bool ok = true;
+
+	if(!initTracker(timed, cameraFile) || !initTracker(serial, cameraFile) || !initTracker(parallel, cameraFile))
+		return 1;
+
+	// marker m of a board sits (m&1)*100 mm to the right and (m>>1)*100 mm below marker 0
+	clearTestImage(pixels, 640, 480);
+	for(b=0; b<NUM_BOARDS; b++)
+	{
+		const double size = 60, angle = 0.1*b, step = size*1.25;
+		const double x0 = 90+(b&1)*320, y0 = 70+(b>>1)*240;
+
+		for(m=0; m<4; m++)
+		{
+			double ox = (m&1)*step, oy = (m>>1)*step;
+			drawTestMarker(pixels, 640, 480, 1+b*4+m, x0+cos(angle)*ox-sin(angle)*oy, y0+sin(angle)*ox+cos(angle)*oy, size, angle);
+		}
+	}
+
+#if !defined(_OPENMP)
+	printf("built without OpenMP\n");
+#endif
+
+	ok = runEstimator(timed, serial, parallel, POSE_ESTIMATOR_ORIGINAL, "ORIGINAL", pixels) && ok;
+	ok = runEstimator(timed, serial, parallel, POSE_ESTIMATOR_RPP, "RPP", pixels) && ok;
+	ok = runEstimator(timed, serial, parallel, POSE_ESTIMATOR_LM, "LM", pixels) && ok;
+
+	delete timed;
+	delete serial;
+	delete parallel;
+
+	printf(ok ? "OK\n" : "FAILED\n");
+	return ok ? 0 : 1;
+}
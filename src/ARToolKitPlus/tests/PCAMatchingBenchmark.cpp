@@ -0,0 +1,230 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+// Compares brute force template correlation with PCA accelerated matching
+// (activatePCAMatching()) for growing pattern libraries and prints the time
+// per pattern_match() call. Also checks that a pattern bundle never stores an
+// eigen-basis which is outdated.
+//
+// Returns 0 if both modes recognize the same samples and the bundle check passes.
+
+
+#include <ARToolKitPlus/TrackerSingleMarkerImpl.h>
+#include <ARToolKitPlus/arPattBundle.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+
+using namespace ARToolKitPlus;
+
+
+#define PATT_FILE		"pcabench.patt"
+#define BUNDLE_FILE		"pcabench.apb"
+#define NUM_SAMPLES		64
+#define NUM_RUNS		200
+
+
+typedef TrackerSingleMarkerImpl<16,16,16,64,32> BenchTracker;
+
+
+class PCATracker : public BenchTracker
+{
+public:
+	int match(ARUint8* nData, int* nCode, int* nDir, ARFloat* nCf)  {  return pattern_match(nData, nCode, nDir, nCf);  }
+
+	// renders the upright image of a loaded pattern
+	void render(int nId, ARUint8* nData)
+	{
+		for(int i=0; i<16*16*3; i++)
+		{
+			int v = 128 - pat[nId][0][i]/2;
+			nData[i] = (ARUint8)(v<0 ? 0 : (v>255 ? 255 : v));
+		}
+	}
+};
+
+
+// writes a random 4x4 block pattern in all four rotations
+static bool
+writeRandomPattern(const char* nFileName)
+{
+	FILE* fp = fopen(nFileName, "w");
+	int blk[4][4], h, c, x, y;
+
+	if(!fp)
+		return false;
+
+	for(y=0; y<4; y++)
+		for(x=0; x<4; x++)
+			blk[y][x] = (rand()%2) ? 230 : 20;
+
+	for(h=0; h<4; h++)
+	{
+		for(c=0; c<3; c++)
+			for(y=0; y<16; y++)
+			{
+				for(x=0; x<16; x++)
+				{
+					int by = y/4, bx = x/4, ry, rx;
+
+					switch(h)
+					{
+					case 0:  ry = by;    rx = bx;    break;
+					case 1:  ry = 3-bx;  rx = by;    break;
+					case 2:  ry = 3-by;  rx = 3-bx;  break;
+					default: ry = bx;    rx = 3-by;  break;
+					}
+					fprintf(fp, "%d ", blk[ry][rx]);
+				}
+				fprintf(fp, "\n");
+			}
+		fprintf(fp, "\n");
+	}
+
+	fclose(fp);
+	return true;
+}
+
+
+static bool
+loadRandomPatterns(PCATracker& nTracker, int nNum)
+{
+	for(int i=0; i<nNum; i++)
+		if(!writeRandomPattern(PATT_FILE) || nTracker.arLoadPatt((char*)PATT_FILE)<0)
+			return false;
+	return true;
+}
+
+
+static bool
+runBenchmark(int nNumPatterns)
+{
+	static ARUint8 samples[NUM_SAMPLES][16*16*3];
+	PCATracker tracker;
+	int i, j, r, code, dir, found[2] = { 0, 0 };
+	double usec[2];
+	ARFloat cf;
+
+	if(!loadRandomPatterns(tracker, nNumPatterns))
+		return false;
+
+	for(i=0; i<NUM_SAMPLES; i++)
+	{
+		tracker.render(i%nNumPatterns, samples[i]);
+		for(j=0; j<16*16*3; j++)
+		{
+			int v = samples[i][j] + rand()%41 - 20;
+			samples[i][j] = (ARUint8)(v<0 ? 0 : (v>255 ? 255 : v));
+		}
+	}
+
+	for(int mode=0; mode<2; mode++)
+	{
+		tracker.activatePCAMatching(mode==1);
+		tracker.match(samples[0], &code, &dir, &cf);		// builds the eigen-basis
+
+		clock_t t0 = clock();
+		for(r=0; r<NUM_RUNS; r++)
+			for(i=0; i<NUM_SAMPLES; i++)
+			{
+				tracker.match(samples[i], &code, &dir, &cf);
+				if(r==0 && code==i%nNumPatterns && dir==0)
+					found[mode]++;
+			}
+		usec[mode] = 1.0e6 * (double)(clock()-t0) / CLOCKS_PER_SEC / (NUM_RUNS*NUM_SAMPLES);
+	}
+
+	printf("%3d patterns: brute force %7.2f us (%2d/%d)   PCA %7.2f us (%2d/%d)\n",
+		   nNumPatterns, usec[0], found[0], NUM_SAMPLES, usec[1], found[1], NUM_SAMPLES);
+
+	return found[0]==found[1];
+}
+
+
+// a basis which got outdated by loading another pattern must not be saved
+static bool
+checkBundleBasis()
+{
+	PCATracker tracker;
+	ARPattBundleHeader header;
+	ARUint8 sample[16*16*3];
+	int code, dir;
+	ARFloat cf;
+
+	if(!loadRandomPatterns(tracker, 8))
+		return false;
+
+	tracker.activatePCAMatching(true);
+	tracker.render(0, sample);
+	tracker.match(sample, &code, &dir, &cf);
+
+	tracker.activatePCAMatching(false);
+	if(!loadRandomPatterns(tracker, 1) || tracker.arSavePattBundle(BUNDLE_FILE)<0)
+		return false;
+
+	FILE* fp = fopen(BUNDLE_FILE, "rb");
+	size_t num = fp ? fread(&header, sizeof(header), 1, fp) : 0;
+
+	if(fp)
+		fclose(fp);
+	remove(BUNDLE_FILE);
+
+	printf("bundle with outdated basis: %d stored dimensions\n", num==1 ? (int)header.evecDim : -1);
+	return num==1 && header.evecDim==0;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	const int sizes[] = { 2, 4, 8, 12, 16, 24, 32, 48, 64 };
+	bool ok = true;
+
+	srand(3);
+
+	for(int i=0; i<(int)(sizeof(sizes)/sizeof(sizes[0])); i++)
+		ok = runBenchmark(sizes[i]) && ok;
+
+	ok = checkBundleBasis() && ok;
+	remove(PATT_FILE);
+
+	printf(ok ? "OK\n" : "FAILED\n");
+	return ok ? 0 : 1;
+}
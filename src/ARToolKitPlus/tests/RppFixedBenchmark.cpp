@@ -0,0 +1,177 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+// Compares robustPlanarPoseFixed() with the generic robustPlanarPose() on
+// noisy synthetic views of a 80x80 mm marker plus up to four extra points.
+// Checks that both return bit-identical poses for 4 to 8 points and prints
+// time and heap allocations per call for the four point case.
+//
+// Returns 0 if all poses are identical.
+
+
+#include <ARToolKitPlus/extra/rpp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <new>
+
+
+#define NUM_POSES		20000
+#define MAX_POINTS		8
+
+
+// counts all heap allocations of the solvers
+static unsigned long numAllocs = 0;
+
+void* operator new(size_t nSize)
+{
+	numAllocs++;
+	void* ptr = malloc(nSize ? nSize : 1);
+	if(!ptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void operator delete(void* nPtr) throw()
+{
+	free(nPtr);
+}
+
+
+static rpp_vec model[NUM_POSES][MAX_POINTS], image[NUM_POSES][MAX_POINTS];
+static int numPoints[NUM_POSES];
+
+static const rpp_float cc[2] = { 160, 120 }, fc[2] = { 400, 400 };
+
+
+static double
+rnd()
+{
+	return rand()/(double)RAND_MAX;
+}
+
+
+// the first half of the poses uses the four marker corners only,
+// the second half adds up to four random points on the marker plane
+static void
+createPoses()
+{
+	for(int k=0; k<NUM_POSES; k++)
+	{
+		const int n = k<NUM_POSES/2 ? 4 : 4+k%5;
+		double a = rnd()-0.5, b = rnd()-0.5, c = rnd()*6;
+		double tx = rnd()*100-50, ty = rnd()*100-50, tz = 200+rnd()*500;
+		double ca = cos(a), sa = sin(a), cb = cos(b), sb = sin(b), cg = cos(c), sg = sin(c);
+		double R[3][3] = { { cg*cb, cg*sb*sa-sg*ca, cg*sb*ca+sg*sa },
+						   { sg*cb, sg*sb*sa+cg*ca, sg*sb*ca-cg*sa },
+						   { -sb,   cb*sa,          cb*ca } };
+
+		numPoints[k] = n;
+
+		for(int i=0; i<n; i++)
+		{
+			double X = i<4 ? ((i==1 || i==2) ? 40 : -40) : rnd()*80-40,
+				   Y = i<4 ? (i<2 ? 40 : -40) : rnd()*80-40;
+			double p[3];
+
+			for(int r=0; r<3; r++)
+				p[r] = R[r][0]*X + R[r][1]*Y + (r==0 ? tx : (r==1 ? ty : tz));
+
+			model[k][i][0] = X;
+			model[k][i][1] = Y;
+			model[k][i][2] = 0;
+			image[k][i][0] = fc[0]*p[0]/p[2] + cc[0] + rnd()-0.5;
+			image[k][i][1] = fc[1]*p[1]/p[2] + cc[1] + rnd()-0.5;
+			image[k][i][2] = 1;
+		}
+	}
+}
+
+
+int
+main()
+{
+	rpp_mat R_init, R0, R1;
+	rpp_vec t0, t1;
+	rpp_float err0, err1, sum = 0;
+	int k, numDiff = 0;
+
+	srand(1);
+	createPoses();
+
+	for(k=0; k<NUM_POSES; k++)
+	{
+		robustPlanarPose(err0, R0, t0, cc, fc, model[k], image[k], numPoints[k], R_init, true, 0, 0, 0);
+		robustPlanarPoseFixed(err1, R1, t1, cc, fc, model[k], image[k], numPoints[k], R_init, true, 0, 0, 0);
+
+		if(memcmp(R0, R1, sizeof(R0))!=0 || memcmp(t0, t1, sizeof(t0))!=0 || err0!=err1)
+			numDiff++;
+	}
+
+	printf("%d of %d poses differ (4 to %d points)\n", numDiff, NUM_POSES, MAX_POINTS);
+
+	// timing of the four point case
+	//
+	for(int fixed=0; fixed<2; fixed++)
+	{
+		unsigned long allocs = numAllocs;
+		clock_t start = clock();
+
+		for(k=0; k<NUM_POSES/2; k++)
+		{
+			if(fixed)
+				robustPlanarPoseFixed(err1, R1, t1, cc, fc, model[k], image[k], 4, R_init, true, 0, 0, 0);
+			else
+				robustPlanarPose(err1, R1, t1, cc, fc, model[k], image[k], 4, R_init, true, 0, 0, 0);
+			sum += err1;
+		}
+
+		printf("%-22s %7.2f us, %6.1f allocations per pose\n", fixed ? "robustPlanarPoseFixed:" : "robustPlanarPose:",
+			   1.0e6 * (double)(clock()-start) / CLOCKS_PER_SEC / (NUM_POSES/2),
+			   (double)(numAllocs-allocs) / (NUM_POSES/2));
+	}
+
+	if(sum!=sum)
+		printf("invalid pose error\n");
+
+	printf(numDiff==0 ? "OK\n" : "FAILED\n");
+	return numDiff==0 ? 0 : 1;
+}
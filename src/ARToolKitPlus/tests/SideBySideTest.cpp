@@ -0,0 +1,172 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+// Runs two TrackerSingleMarkerImpl instances with different frame sizes
+// (320x240 and 640x480) interleaved and compares their results with running
+// each tracker alone. Both trackers are constructed before either of them is
+// initialized, so any state shared between the instances shows up.
+//
+// Usage: SideBySideTest [camera file]
+// Returns 0 if the interleaved results match the separate runs.
+
+
+#include <ARToolKitPlus/TrackerSingleMarkerImpl.h>
+#include "SyntheticMarkers.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+
+using namespace ARToolKitPlus;
+
+
+#define NUM_FRAMES				10
+
+
+typedef TrackerSingleMarkerImpl<6,6,6,1,8> SideTracker;
+
+
+struct TestImage
+{
+	int				width, height;
+	unsigned char	*pixels;
+};
+
+
+static bool
+initTracker(SideTracker* nTracker, const char* nCameraFile)
+{
+	nTracker->setPixelFormat(PIXEL_FORMAT_LUM);
+
+	if(!nTracker->init(nCameraFile, 1.0f, 1000.0f))
+	{
+		printf("could not load camera file '%s'\n", nCameraFile);
+		return false;
+	}
+
+	nTracker->setPatternWidth(80);
+	nTracker->setBorderWidth(0.25f);
+	nTracker->setThreshold(128);
+	nTracker->setMarkerMode(MARKER_ID_BCH);
+	return true;
+}
+
+
+// stores the detected id and the first three rows of the model view matrix
+static void
+runTracker(SideTracker* nTracker, const TestImage& nImage, ARFloat nResult[13])
+{
+	const ARFloat* mat;
+
+	nResult[0] = (ARFloat)nTracker->calc(nImage.pixels);
+	mat = nTracker->getModelViewMatrix();
+
+	for(int i=0; i<12; i++)
+		nResult[i+1] = mat[i];
+}
+
+
+static int
+compareResults(const ARFloat nA[13], const ARFloat nB[13])
+{
+	int num = 0;
+
+	for(int i=0; i<13; i++)
+		if(fabs(nA[i]-nB[i]) > 1.0e-4)
+			num++;
+	return num;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	const char* cameraFile = argc>1 ? argv[1] : TEST_CAMERA_FILE;
+	static unsigned char pixelsSmall[320*240], pixelsLarge[640*480];
+	TestImage imgSmall = { 320, 240, pixelsSmall }, imgLarge = { 640, 480, pixelsLarge };
+	ARFloat aloneSmall[13], aloneLarge[13], result[13];
+	SideTracker *small, *large;
+	int f, numDiff = 0;
+
+	clearTestImage(imgSmall.pixels, imgSmall.width, imgSmall.height);
+	drawTestMarker(imgSmall.pixels, imgSmall.width, imgSmall.height, 7, 150, 110, 70, 0.2);
+	clearTestImage(imgLarge.pixels, imgLarge.width, imgLarge.height);
+	drawTestMarker(imgLarge.pixels, imgLarge.width, imgLarge.height, 7, 300, 220, 140, 0.2);
+
+	// reference: every tracker on its own
+	small = new SideTracker(320, 240);
+	if(!initTracker(small, cameraFile))
+		return 1;
+	runTracker(small, imgSmall, aloneSmall);
+	delete small;
+
+	large = new SideTracker(640, 480);
+	if(!initTracker(large, cameraFile))
+		return 1;
+	runTracker(large, imgLarge, aloneLarge);
+	delete large;
+
+	if(aloneSmall[0]!=7 || aloneLarge[0]!=7)
+	{
+		printf("marker not found when running alone (%d, %d)\n", (int)aloneSmall[0], (int)aloneLarge[0]);
+		return 1;
+	}
+
+	// side by side
+	small = new SideTracker(320, 240);
+	large = new SideTracker(640, 480);
+	if(!initTracker(small, cameraFile) || !initTracker(large, cameraFile))
+		return 1;
+
+	for(f=0; f<NUM_FRAMES; f++)
+	{
+		runTracker(small, imgSmall, result);
+		numDiff += compareResults(result, aloneSmall);
+
+		runTracker(large, imgLarge, result);
+		numDiff += compareResults(result, aloneLarge);
+	}
+
+	delete small;
+	delete large;
+
+	printf("side by side: %d differences to running alone\n", numDiff);
+	printf(numDiff==0 ? "OK\n" : "FAILED\n");
+	return numDiff==0 ? 0 : 1;
+}
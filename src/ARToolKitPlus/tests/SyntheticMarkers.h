@@ -0,0 +1,100 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+#ifndef __ARTOOLKITPLUS_TESTS_SYNTHETICMARKERS_HEADERFILE__
+#define __ARTOOLKITPLUS_TESTS_SYNTHETICMARKERS_HEADERFILE__
+
+
+#include <ARToolKitPlus/TrackerImpl.h>
+#include <string.h>
+#include <math.h>
+
+
+// camera file used by the tests when run from the tests directory
+#define TEST_CAMERA_FILE	"../../../samples/ArtkpApp/assets/camera_para.dat"
+
+
+namespace ARToolKitPlus {
+
+
+// fills a LUM8 image with white
+inline void
+clearTestImage(unsigned char* nPixels, int nWidth, int nHeight)
+{
+	memset(nPixels, 255, nWidth*nHeight);
+}
+
+
+// draws the BCH marker nId centered at (nCx,nCy) with side length nSize and
+// rotation nAngle into a LUM8 image. the border is a quarter of the size.
+inline void
+drawTestMarker(unsigned char* nPixels, int nWidth, int nHeight, int nId,
+			   double nCx, double nCy, double nSize, double nAngle)
+{
+	IDPATTERN pat;
+	const double ca = cos(nAngle), sa = sin(nAngle);
+
+	generatePatternBCH(nId, pat);
+
+	for(int y=0; y<nHeight; y++)
+		for(int x=0; x<nWidth; x++)
+		{
+			double dx = x+0.5-nCx, dy = y+0.5-nCy;
+			double u = ( ca*dx + sa*dy)/nSize + 0.5;
+			double v = (-sa*dx + ca*dy)/nSize + 0.5;
+			unsigned char& p = nPixels[y*nWidth+x];
+
+			if(u<0 || u>=1 || v<0 || v>=1)
+				continue;
+
+			if(u<0.25 || u>=0.75 || v<0.25 || v>=0.75)
+				p = 0;
+			else
+			{
+				int gx = (int)((u-0.25)*12), gy = (int)((v-0.25)*12);
+				p = ((pat>>(35-gy*6-gx)) & 1) ? 255 : 0;
+			}
+		}
+}
+
+
+}  // namespace ARToolKitPlus
+
+
+#endif //__ARTOOLKITPLUS_TESTS_SYNTHETICMARKERS_HEADERFILE__
@@ -0,0 +1,180 @@
+/* ========================================================================
+ * PROJECT: ARToolKitPlus
+ * ========================================================================
+ * This work is based on the original ARToolKit developed by
+ *   Hirokazu Kato
+ *   Mark Billinghurst
+ *   HITLab, University of Washington, Seattle
+ * http://www.hitl.washington.edu/artoolkit/
+ *
+ * Copyright of the derived and new portions of this work
+ *     (C) 2006 Graz University of Technology
+ *
+ * This framework is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This framework is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this framework; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * For further information please contact 
+ *   Dieter Schmalstieg
+ *   <schmalstieg@icg.tu-graz.ac.at>
+ *   Graz University of Technology, 
+ *   Institut for Computer Graphics and Vision,
+ *   Inffeldgasse 16a, 8010 Graz, Austria.
+ * ========================================================================
+ *
+ * $Id$
+ * @file
+ * ======================================================================== */
+
+
+// Builds the full (UNDIST_LUT) and the sparse (UNDIST_LUT_SPARSE) undistortion
+// tables for a 640x480 image with different numbers of OpenMP threads and
+// checks that the tables do not depend on the number of threads. Without
+// OpenMP only the serial time is printed.
+//
+// Usage: UndistLUTBenchmark [camera file]
+// Returns 0 if all thread counts give the same tables.
+
+
+#include <ARToolKitPlus/TrackerSingleMarkerImpl.h>
+#include "SyntheticMarkers.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+
+using namespace ARToolKitPlus;
+
+
+#define IMAGE_WIDTH		640
+#define IMAGE_HEIGHT	480
+#define NUM_RUNS		20
+
+
+class UndistTracker : public TrackerSingleMarkerImpl<6,6,6,1,8>
+{
+public:
+	UndistTracker() : TrackerSingleMarkerImpl<6,6,6,1,8>(IMAGE_WIDTH, IMAGE_HEIGHT)  {}
+
+	void buildFullTable()  {  buildUndistO2ITable(arCamera);  }
+	void buildSparseTable()  {  buildUndistSparseTable(arCamera);  }
+
+	const ARUndistEntry* getFullTable() const  {  return undistO2ITable;  }
+	const ARUndistEntry* getSparseTable() const  {  return undistSparseTable;  }
+
+	size_t getFullTableSize() const  {  return (size_t)arImXsize*arImYsize;  }
+	size_t getSparseTableSize() const  {  return (size_t)undistSparseXsize*undistSparseYsize;  }
+};
+
+
+typedef void (UndistTracker::* BUILD_FUNC)();
+typedef const ARUndistEntry* (UndistTracker::* TABLE_FUNC)() const;
+typedef size_t (UndistTracker::* SIZE_FUNC)() const;
+
+
+// wall clock time, clock() would sum up the time of all threads
+static double
+getSeconds()
+{
+#if defined(_OPENMP)
+	return omp_get_wtime();
+#else
+	return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+
+static bool
+runTable(UndistTracker& nTracker, BUILD_FUNC nBuild, TABLE_FUNC nTable, SIZE_FUNC nSize, const char* nName)
+{
+	ARUndistEntry* refTable;
+	size_t size;
+	bool same = true;
+	int maxThreads = 1;
+
+#if defined(_OPENMP)
+	maxThreads = omp_get_max_threads();
+	omp_set_num_threads(1);
+#endif
+
+	(nTracker.*nBuild)();
+	size = (nTracker.*nSize)();
+	if((nTracker.*nTable)()==NULL || size==0)
+	{
+		printf("%s: table was not built\n", nName);
+		return false;
+	}
+
+	refTable = new ARUndistEntry[size];
+	memcpy(refTable, (nTracker.*nTable)(), size*sizeof(ARUndistEntry));
+
+	for(int threads=1; threads<=maxThreads; threads*=2)
+	{
+#if defined(_OPENMP)
+		omp_set_num_threads(threads);
+#endif
+		double start = getSeconds();
+
+		for(int r=0; r<NUM_RUNS; r++)
+			(nTracker.*nBuild)();
+
+		double usec = 1.0e6 * (getSeconds()-start) / NUM_RUNS;
+
+		if((nTracker.*nSize)()!=size || memcmp((nTracker.*nTable)(), refTable, size*sizeof(ARUndistEntry))!=0)
+			same = false;
+
+		printf("%-7s %2d thread(s): %9.1f us per table of %d entries\n", nName, threads, usec, (int)size);
+	}
+
+#if defined(_OPENMP)
+	omp_set_num_threads(maxThreads);
+#endif
+
+	if(!same)
+		printf("%s: table depends on the number of threads\n", nName);
+
+	delete [] refTable;
+	return same;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	const char* cameraFile = argc>1 ? argv[1] : TEST_CAMERA_FILE;
+	UndistTracker* tracker = new UndistTracker();
+	bool ok = true;
+
+	if(!tracker->init(cameraFile, 1.0f, 1000.0f))
+	{
+		printf("could not load camera file '%s'\n", cameraFile);
+		delete tracker;
+		return 1;
+	}
+
+#if !defined(_OPENMP)
+	printf("built without OpenMP\n");
+#endif
+
+	ok = runTable(*tracker, &UndistTracker::buildFullTable, &UndistTracker::getFullTable, &UndistTracker::getFullTableSize, "LUT") && ok;
+	ok = runTable(*tracker, &UndistTracker::buildSparseTable, &UndistTracker::getSparseTable, &UndistTracker::getSparseTableSize, "SPARSE") && ok;
+
+	delete tracker;
+
+	printf(ok ? "OK\n" : "FAILED\n");
+	return ok ? 0 : 1;
+}
@@ -34,13 +34,72 @@ void ArTracker::update( Surface &surface )
 {
 	if ( !mObj->mOptions.mMultiMarker )
 	{
-		// TODO filter out -1 ids from mMarkerInfo
-		mObj->mTrackerSingleRef->calc( surface.getData(), -1, false, &mObj->mMarkerInfo, &mObj->mNumMarkers );
+		ARToolKitPlus::ARMarkerInfo *markerInfo;
+		int numMarkers;
+		mObj->mTrackerSingleRef->calc( surface.getData(), -1, false, &markerInfo, &numMarkers );
+
+		mObj->mMarkerInfo.clear();
+		for ( int i = 0; i < numMarkers; i++ )
+		{
+			if ( markerInfo[ i ].id != -1 )
+				mObj->mMarkerInfo.push_back( markerInfo[ i ] );
+		}
+		mObj->mNumMarkers = (int)mObj->mMarkerInfo.size();
+
+		// estimate all poses in one go, getModelView only looks them up
+		mObj->mPatternTrans.resize( mObj->mNumMarkers * 12 );
+		mObj->mPatternErr.resize( mObj->mNumMarkers );
+		if ( mObj->mNumMarkers > 0 )
+		{
+			ARFloat patternCenter[ 2 ] = { 0.f, 0.f };
+			int numFound = mObj->mTrackerSingleRef->executeSingleMarkerPoseEstimatorBatch( &mObj->mMarkerInfo[ 0 ], mObj->mNumMarkers,
+					patternCenter, mObj->mOptions.mPatternWidth,
+					reinterpret_cast< ARFloat (*)[ 3 ][ 4 ] >( &mObj->mPatternTrans[ 0 ] ), &mObj->mPatternErr[ 0 ] );
+
+			// a negative error means no pose was found, drop these markers so the
+			// indices of getMarkerId and getModelView still match
+			if ( numFound < mObj->mNumMarkers )
+			{
+				int n = 0;
+				for ( int i = 0; i < mObj->mNumMarkers; i++ )
+				{
+					if ( mObj->mPatternErr[ i ] < 0.f )
+						continue;
+					if ( n != i )
+					{
+						mObj->mMarkerInfo[ n ] = mObj->mMarkerInfo[ i ];
+						mObj->mPatternErr[ n ] = mObj->mPatternErr[ i ];
+						memcpy( &mObj->mPatternTrans[ n * 12 ], &mObj->mPatternTrans[ i * 12 ], sizeof( ARFloat ) * 12 );
+					}
+					n++;
+				}
+				mObj->mNumMarkers = n;
+				mObj->mMarkerInfo.resize( n );
+				mObj->mPatternErr.resize( n );
+				mObj->mPatternTrans.resize( n * 12 );
+			}
+		}
 	}
 	else
 	{
 		mObj->mTrackerMultiRef->calc( surface.getData() );
 		mObj->mNumMarkers = mObj->mTrackerMultiRef->getNumDetectedMarkers();
+
+		// every marker shares the pose of the multi marker configuration
+		const ARToolKitPlus::ARMultiMarkerInfoT *mmConfig = mObj->mTrackerMultiRef->getMultiMarkerConfig();
+		mObj->mPatternTrans.resize( mObj->mNumMarkers * 12 );
+		for ( int i = 0; i < mObj->mNumMarkers; i++ )
+			memcpy( &mObj->mPatternTrans[ i * 12 ], mmConfig->trans, sizeof( ARFloat ) * 12 );
+	}
+
+	mObj->mModelViews.resize( mObj->mNumMarkers );
+	for ( int i = 0; i < mObj->mNumMarkers; i++ )
+	{
+		const ARFloat (*patternTrans)[ 4 ] = reinterpret_cast< const ARFloat (*)[ 4 ] >( &mObj->mPatternTrans[ i * 12 ] );
+		mObj->mModelViews[ i ] = Matrix44f( patternTrans[ 0 ][ 0 ], patternTrans[ 1 ][ 0 ], patternTrans[ 2 ][ 0 ], 0.f,
+				patternTrans[ 0 ][ 1 ], patternTrans[ 1 ][ 1 ], patternTrans[ 2 ][ 1 ], 0.f,
+				patternTrans[ 0 ][ 2 ], patternTrans[ 1 ][ 2 ], patternTrans[ 2 ][ 2 ], 0.f,
+				patternTrans[ 0 ][ 3 ], patternTrans[ 1 ][ 3 ], patternTrans[ 2 ][ 3], 1.f );
 	}
 }
 
@@ -104,53 +163,12 @@ void ArTracker::setProjection() const
 #endif
 }
 
-ci::Matrix44f ArTracker::getModelView( int i ) const
+const ci::Matrix44f &ArTracker::getModelView( int i ) const
 {
 	if ( ( i < 0 ) || ( i >= mObj->mNumMarkers ) )
 		throw ArTrackerExcMarkerIndexOutOfRange();
 
-	Matrix44f modelView;
-	float glModelView[ 16 ];
-	ARFloat patternWidth = mObj->mOptions.mPatternWidth;
-	ARFloat patternCenter[ 2 ] = { 0.f, 0.f };
-	ARFloat patternTrans[ 3 ][ 4 ];
-	if ( !mObj->mOptions.mMultiMarker )
-	{
-		// TODO: check the return value
-		// FIXME: calc has done this already, hasn't it? check where the transformation is stored
-		mObj->mTrackerSingleRef->executeSingleMarkerPoseEstimator( &mObj->mMarkerInfo[ i ], patternCenter, patternWidth, patternTrans );
-	}
-	else
-	{
-		const ARToolKitPlus::ARMultiMarkerInfoT *mmConfig = mObj->mTrackerMultiRef->getMultiMarkerConfig();
-
-#if 0
-		ARToolKitPlus::ARMarkerInfo markers[ mObj->mNumMarkers ];
-		for ( int i = 0; i < mObj->mNumMarkers; i++ )
-		{
-			markers[ i ] = mObj->mTrackerMultiRef->getDetectedMarker( i );
-		}
-
-		// TODO check the return value
-		// FIXME: calc has done this already, hasn't it?
-		mObj->mTrackerMultiRef->executeMultiMarkerPoseEstimator( markers, mObj->mNumMarkers, &mmConfig );
-#endif
-
-		memcpy( patternTrans, mmConfig->trans, sizeof( ARFloat ) * 12 );
-	}
-
-	for ( int j = 0; j < 3; j++ )
-	{
-		for( int i = 0; i < 4; i++ )
-		{
-			glModelView[ i * 4 + j ] = patternTrans[ j ][ i ];
-		}
-	}
-
-	return Matrix44f( patternTrans[ 0 ][ 0 ], patternTrans[ 1 ][ 0 ], patternTrans[ 2 ][ 0 ], 0.f,
-					patternTrans[ 0 ][ 1 ], patternTrans[ 1 ][ 1 ], patternTrans[ 2 ][ 1 ], 0.f,
-					patternTrans[ 0 ][ 2 ], patternTrans[ 1 ][ 2 ], patternTrans[ 2 ][ 2 ], 0.f,
-					patternTrans[ 0 ][ 3 ], patternTrans[ 1 ][ 3 ], patternTrans[ 2 ][ 3], 1.f );
+	return mObj->mModelViews[ i ];
 }
 
 void ArTracker::setModelView( int i ) const
@@ -159,7 +177,7 @@ void ArTracker::setModelView( int i ) const
 		throw ArTrackerExcMarkerIndexOutOfRange();
 
 	glMatrixMode( GL_MODELVIEW );
-	glLoadMatrixf( getModelView( i ).m );
+	glLoadMatrixf( mObj->mModelViews[ i ].m );
 }
 
 void ArTracker::enableAutoThreshold( bool enable )
@@ -249,8 +267,9 @@ ArTracker::Obj::Obj( int32_t width, int32_t height, Options options )
 		mTrackerMultiRef->activateAutoThreshold( options.mThresholdAuto );
 		mTrackerMultiRef->setImageProcessingMode( (ARToolKitPlus::IMAGE_PROC_MODE)( AR_IMAGE_PROC_IN_FULL ) );
 
-		// NOTE: RPP "Robust Planar Pose" estimator does not work for 3d multi marker objects
-		mTrackerMultiRef->setPoseEstimator( ARToolKitPlus::POSE_ESTIMATOR_ORIGINAL );
+		// NOTE: RPP "Robust Planar Pose" estimator does not work for 3d multi marker objects,
+		// the LM estimator handles both planar boards and 3d rigs
+		mTrackerMultiRef->setPoseEstimator( ARToolKitPlus::POSE_ESTIMATOR_LM );
 		//mTrackerMultiRef->setPoseEstimator( ARToolKitPlus::POSE_ESTIMATOR_ORIGINAL_CONT );
 
 		mTrackerMultiRef->setMarkerMode( static_cast< ARToolKitPlus::MARKER_MODE >( options.mMode ) );
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <iostream>
+#include <vector>
 
 #include "ARToolKitPlus/TrackerSingleMarker.h"
 #include "ARToolKitPlus/TrackerMultiMarker.h"
@@ -56,7 +57,7 @@ class ArTracker
 		//! Creates an ArTracker for a \a width pixels wide and \a height pixels high camera image, using ArTracker::Options \a options.
 		ArTracker( int32_t width, int32_t height, Options options = Options() );
 
-		//! Detects the markers in the \a surface.
+		//! Detects the markers in the \a surface. Markers without a pose are skipped.
 		void update( ci::Surface &surface );
 
 		//! Returns the number of markers. id of the marker with the given index \a i.
@@ -71,8 +72,8 @@ class ArTracker
 		//! Sets the \c PROJECTION matrix to reflect the values of the camera parameter file loaded for the ArTracker. Leaves the \c MatrixMode as \c PROJECTION.
 		void setProjection() const;
 
-		//! Returns the value of the \a i'th marker's \c MODELVIEW matrix as a Matrix44f.
-		ci::Matrix44f getModelView( int i ) const;
+		//! Returns the value of the \a i'th marker's \c MODELVIEW matrix as a Matrix44f. The matrices are calculated once per update().
+		const ci::Matrix44f &getModelView( int i ) const;
 
 		//! Sets the \c MODELVIEW matrix to reflect the values of the \a i'th marker. Leaves the \c MatrixMode as \c MODELVIEW.
 		void setModelView( int i ) const;
@@ -148,7 +149,11 @@ class ArTracker
 			Options mOptions;
 
 			int mNumMarkers = 0;
-			ARToolKitPlus::ARMarkerInfo *mMarkerInfo;
+			std::vector< ARToolKitPlus::ARMarkerInfo > mMarkerInfo; //!< markers with a valid id and pose (single marker mode)
+
+			std::vector< ARFloat > mPatternTrans; //!< 3x4 transformation per marker
+			std::vector< ARFloat > mPatternErr;
+			std::vector< ci::Matrix44f > mModelViews; //!< per frame \c MODELVIEW matrix cache
 		};
 
 		std::shared_ptr< Obj > mObj;